@@ -21,6 +21,7 @@ layout (std430, binding = 5) buffer SupportBuffer	{ vec4		vertexList[]; };
 uniform float		isolevel;
 uniform uvec3		localSize;
 uniform mat4		modelMatrix;
+uniform uvec3		paddedDims;
 uniform uvec3		start;
 uniform int			targetValue;
 
@@ -63,6 +64,15 @@ uvec3 getPosition2(uint index)
 	return uvec3(x, y, z);
 }
 
+// The grid is surrounded by a virtual border of free voxels, (1, 1, 1) being its first voxel
+uint16_t getLabel(ivec3 position)
+{
+	if (any(lessThan(position, ivec3(1))) || any(greaterThan(position, ivec3(gridDims))))
+		return VOXEL_FREE;
+
+	return grid[getPositionIndex(uvec3(position - 1))];
+}
+
 vec3 findVertex(in ivec3 cellIndices, in float isolevel, in ivec2 edge, float value_1, float value_2)
 {
 	// Grab the two vertices at either end of the edge between `index_1` and `index_2`
@@ -95,7 +105,7 @@ bool ccw(uint offset)
 
 void march(in uint index, in ivec3 cellIndices)
 {
-	uvec3 volumeSize = gridDims;
+	uvec3 volumeSize = paddedDims;
 	vec3 invVolumeSize = 1.0 / vec3(volumeSize);
 
 	// Avoid sampling outside of the volume bounds
@@ -108,7 +118,7 @@ void march(in uint index, in ivec3 cellIndices)
 	for (int i = 0; i < 8; ++i)
 	{
 		// Sample the volume texture at this neighbor's coordinates
-		values[i] = float(unmasked(grid[getPositionIndex(cellIndices + neighbors[i])]) == uint16_t(targetValue));
+		values[i] = float(unmasked(getLabel(cellIndices + neighbors[i])) == uint16_t(targetValue));
 
 		// Compare the sampled value to the user-specified isolevel
 		if (values[i] < isolevel)
@@ -147,7 +157,7 @@ void march(in uint index, in ivec3 cellIndices)
 			//	vertexData[offset + 2].xyz = vertexList[index * 12 + triangleTable[triangleStartMemory + (3 * i + 1)]].xyz;
 			//}
 
-			float isBoundary = float(isBoundary(grid[getPositionIndex(cellIndices)]));
+			float isBoundary = float(isBoundary(getLabel(cellIndices)));
 			vertexData[offset + 0].w = isBoundary;
 			vertexData[offset + 1].w = isBoundary;
 			vertexData[offset + 2].w = isBoundary;
@@ -0,0 +1,137 @@
+#pragma once
+
+#include "Utilities/MappedFile.h"
+
+/**
+*	@file GridStorage.h
+*	@authors Alfonso Lpez Ruiz (alr00048@red.ujaen.es)
+*	@date 19/10/2026
+*/
+
+/**
+*	@brief Linear buffer of voxels which lives either in the heap or in a memory-mapped file (out-of-core). Both share the same layout, 
+*	so that algorithms working over raw pointers are unaware of the backing store.
+*/
+template<typename T>
+class GridStorage
+{
+protected:
+	T*							_data;					//!< Beginning of the buffer, either in the heap or in the mapped file
+	std::vector<T>				_heap;					//!< In-core buffer
+	std::unique_ptr<MappedFile>	_mappedFile;			//!< Out-of-core buffer
+	size_t						_size;					//!< Number of elements
+
+public:
+	/**
+	*	@brief Constructor of an empty storage.
+	*/
+	GridStorage() : _data(nullptr), _size(0) {}
+
+	/**
+	*	@brief Invalid copy constructor.
+	*/
+	GridStorage(const GridStorage& storage) = delete;
+
+	/**
+	*	@brief Allocates the buffer in the heap.
+	*/
+	void allocate(size_t size, const T& value = T());
+
+	/**
+	*	@brief Allocates the buffer in a temporary memory-mapped file. Falls back to the heap if the file cannot be mapped.
+	*	@return True if the buffer is backed by the file.
+	*/
+	bool allocate(const std::string& filename, size_t size, const T& value = T());
+
+	/**
+	*	@brief Hints the OS that the elements [first, first + count) are no longer needed, so that their pages can leave the resident set.
+	*/
+	void evict(size_t first, size_t count);
+
+	/**
+	*	@return True if the buffer is backed by a memory-mapped file.
+	*/
+	bool isMapped() const { return _mappedFile != nullptr; }
+
+	/**
+	*	@brief Hints the OS that the elements [first, first + count) are about to be accessed.
+	*/
+	void prefetch(size_t first, size_t count) const;
+
+	/**
+	*	@brief Frees the buffer, whatever its backing store.
+	*/
+	void release();
+
+	/**
+	*	@return Number of elements.
+	*/
+	size_t size() const { return _size; }
+
+	// ---------- Access ----------
+
+	T* begin() { return _data; }
+	const T* begin() const { return _data; }
+	T* data() { return _data; }
+	const T* data() const { return _data; }
+	T* end() { return _data + _size; }
+	const T* end() const { return _data + _size; }
+	T& operator[](size_t idx) { return _data[idx]; }
+	const T& operator[](size_t idx) const { return _data[idx]; }
+};
+
+template<typename T>
+inline void GridStorage<T>::allocate(size_t size, const T& value)
+{
+	this->release();
+
+	_heap = std::vector<T>(size, value);
+	_data = _heap.data();
+	_size = size;
+}
+
+template<typename T>
+inline bool GridStorage<T>::allocate(const std::string& filename, size_t size, const T& value)
+{
+	this->release();
+
+	_mappedFile = std::make_unique<MappedFile>();
+	if (!size || !_mappedFile->create(filename, size * sizeof(T), true))
+	{
+		_mappedFile.reset();
+		this->allocate(size, value);
+
+		return false;
+	}
+
+	_data = static_cast<T*>(_mappedFile->data());
+	_size = size;
+	
+	// Newly created files are zero-initialized
+	const char* valueBytes = reinterpret_cast<const char*>(&value);
+	if (std::any_of(valueBytes, valueBytes + sizeof(T), [](char byte) { return byte != 0; }))
+		std::fill(_data, _data + _size, value);
+
+	return true;
+}
+
+template<typename T>
+inline void GridStorage<T>::evict(size_t first, size_t count)
+{
+	if (_mappedFile) _mappedFile->evict(first * sizeof(T), count * sizeof(T));
+}
+
+template<typename T>
+inline void GridStorage<T>::prefetch(size_t first, size_t count) const
+{
+	if (_mappedFile) _mappedFile->prefetch(first * sizeof(T), count * sizeof(T));
+}
+
+template<typename T>
+inline void GridStorage<T>::release()
+{
+	_mappedFile.reset();
+	_heap = std::vector<T>();
+	_data = nullptr;
+	_size = 0;
+}
@@ -0,0 +1,193 @@
+#include "stdafx.h"
+#include "MeshCache.h"
+
+#include "Utilities/FileManagement.h"
+#include "Utilities/HashUtilities.h"
+
+/// [Public methods]
+
+MeshCache::MeshCache() : _components(nullptr), _header(nullptr)
+{
+}
+
+MeshCache::~MeshCache()
+{
+	this->close();
+}
+
+void MeshCache::close()
+{
+	_mappedFile.close();
+	_header = nullptr;
+	_components = nullptr;
+}
+
+uint64_t MeshCache::getSourceHash(const std::string& sourceFile)
+{
+	std::error_code errorCode;
+	const std::filesystem::path path(sourceFile);
+
+	const uint64_t fileSize = std::filesystem::file_size(path, errorCode);
+	if (errorCode) return 0;
+
+	const int64_t writeTime = std::filesystem::last_write_time(path, errorCode).time_since_epoch().count();
+	if (errorCode) return 0;
+
+	const std::string absolutePath = std::filesystem::absolute(path, errorCode).generic_string();
+	uint64_t sourceHash = HashUtilities::fnv1a(absolutePath.data(), absolutePath.size());
+	sourceHash = HashUtilities::fnv1a(&fileSize, sizeof(uint64_t), sourceHash);
+	sourceHash = HashUtilities::fnv1a(&writeTime, sizeof(int64_t), sourceHash);
+
+	return sourceHash ? sourceHash : 1;
+}
+
+bool MeshCache::open(const std::string& filename, uint64_t sourceHash)
+{
+	this->close();
+
+	if (!_mappedFile.open(filename, MappedFile::READ_ONLY) || _mappedFile.size() < sizeof(Header))
+	{
+		this->close();
+		return false;
+	}
+
+	const Header* header = static_cast<const Header*>(_mappedFile.data());
+	const ComponentEntry* components = reinterpret_cast<const ComponentEntry*>(header + 1);
+	const size_t tableEnd = sizeof(Header) + size_t(header->_numComponents) * sizeof(ComponentEntry);
+
+	bool valid =
+		std::equal(MAGIC, MAGIC + 4, header->_magic) && header->_version == VERSION && header->_fileSize == _mappedFile.size() &&
+		(sourceHash == 0 || header->_sourceHash == sourceHash) && tableEnd <= _mappedFile.size() && 
+		MeshCache::hashHeader(*header, components) == header->_headerHash;
+
+	// Every stream must lie within the file
+	for (unsigned componentIdx = 0; valid && componentIdx < header->_numComponents; ++componentIdx)
+	{
+		const ComponentEntry& component = components[componentIdx];
+		const uint64_t streamSizes[4] = { component._numVertices * sizeof(vec3), component._numFaces * sizeof(uvec3), component._numVertices * sizeof(vec3), component._numVertices * sizeof(vec2) };
+		const uint64_t streamOffsets[4] = { component._positionOffset, component._faceOffset, component._normalOffset, component._textCoordOffset };
+
+		for (int streamIdx = 0; streamIdx < 4; ++streamIdx)
+			valid &= (streamIdx >= 2 && streamOffsets[streamIdx] == 0) || (streamOffsets[streamIdx] >= tableEnd && streamOffsets[streamIdx] % ALIGNMENT == 0 && streamOffsets[streamIdx] + streamSizes[streamIdx] <= _mappedFile.size());
+	}
+
+	// Streams are checked last, as hashing them reads the whole file (which also brings it into memory)
+	if (valid)
+	{
+		_mappedFile.prefetch(0, _mappedFile.size());
+		valid = HashUtilities::fnv1a(static_cast<const char*>(_mappedFile.data()) + tableEnd, _mappedFile.size() - tableEnd) == header->_dataHash;
+	}
+
+	if (!valid)
+	{
+		this->close();
+		return false;
+	}
+
+	_header = header;
+	_components = components;
+
+	return true;
+}
+
+bool MeshCache::write(const std::string& filename, uint64_t sourceHash, const std::vector<Model3D::ModelComponent*>& components, const AABB& aabb, uint32_t streams)
+{
+	auto align = [](uint64_t offset) { return (offset + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT; };
+
+	Header header = {};
+	std::copy(MAGIC, MAGIC + 4, header._magic);
+	header._version = VERSION;
+	header._sourceHash = sourceHash;
+	header._numComponents = uint32_t(components.size());
+	header._streams = streams;
+	header._min = aabb.min();
+	header._max = aabb.max();
+
+	// Streams are laid out after the table, component by component
+	std::vector<ComponentEntry> entries(components.size(), ComponentEntry{});
+	uint64_t offset = sizeof(Header) + entries.size() * sizeof(ComponentEntry);
+
+	for (unsigned componentIdx = 0; componentIdx < components.size(); ++componentIdx)
+	{
+		ComponentEntry& entry = entries[componentIdx];
+		entry._numVertices = components[componentIdx]->_geometry.size();
+		entry._numFaces = components[componentIdx]->_topology.size();
+		entry._min = components[componentIdx]->_aabb.min();
+		entry._max = components[componentIdx]->_aabb.max();
+
+		entry._positionOffset = offset = align(offset);
+		offset += entry._numVertices * sizeof(vec3);
+		entry._faceOffset = offset = align(offset);
+		offset += entry._numFaces * sizeof(uvec3);
+		entry._normalOffset = entry._textCoordOffset = 0;
+
+		if (streams & NORMALS)
+		{
+			entry._normalOffset = offset = align(offset);
+			offset += entry._numVertices * sizeof(vec3);
+		}
+
+		if (streams & TEXTURE_COORDINATES)
+		{
+			entry._textCoordOffset = offset = align(offset);
+			offset += entry._numVertices * sizeof(vec2);
+		}
+	}
+
+	header._fileSize = offset;
+
+	// Filled in place through a mapping of a temporary file, so that concurrent runs never map an incomplete entry
+	std::error_code errorCode;
+	const std::string temporaryFilename = filename + ".tmp" + FileManagement::getUniqueSuffix();
+	MappedFile mappedFile;
+	if (!mappedFile.create(temporaryFilename, header._fileSize)) return false;
+
+	char* data = static_cast<char*>(mappedFile.data());
+	std::copy(reinterpret_cast<const char*>(entries.data()), reinterpret_cast<const char*>(entries.data() + entries.size()), data + sizeof(Header));
+
+	for (unsigned componentIdx = 0; componentIdx < components.size(); ++componentIdx)
+	{
+		const Model3D::ModelComponent* component = components[componentIdx];
+		const ComponentEntry& entry = entries[componentIdx];
+		vec3* positions = reinterpret_cast<vec3*>(data + entry._positionOffset);
+		uvec3* faces = reinterpret_cast<uvec3*>(data + entry._faceOffset);
+		vec3* normals = entry._normalOffset ? reinterpret_cast<vec3*>(data + entry._normalOffset) : nullptr;
+		vec2* textCoords = entry._textCoordOffset ? reinterpret_cast<vec2*>(data + entry._textCoordOffset) : nullptr;
+
+#pragma omp parallel for
+		for (int vertexIdx = 0; vertexIdx < int(entry._numVertices); ++vertexIdx)
+		{
+			positions[vertexIdx] = component->_geometry[vertexIdx]._position;
+			if (normals) normals[vertexIdx] = component->_geometry[vertexIdx]._normal;
+			if (textCoords) textCoords[vertexIdx] = component->_geometry[vertexIdx]._textCoord;
+		}
+
+#pragma omp parallel for
+		for (int faceIdx = 0; faceIdx < int(entry._numFaces); ++faceIdx)
+			faces[faceIdx] = component->_topology[faceIdx]._vertices;
+	}
+
+	// Both hashes are known once the streams are filled; padding between streams is zero in a newly created file
+	const uint64_t tableEnd = sizeof(Header) + entries.size() * sizeof(ComponentEntry);
+	header._dataHash = HashUtilities::fnv1a(data + tableEnd, header._fileSize - tableEnd);
+	header._headerHash = MeshCache::hashHeader(header, entries.data());
+	std::copy(reinterpret_cast<const char*>(&header), reinterpret_cast<const char*>(&header + 1), data);
+
+	mappedFile.flush(0, header._fileSize);
+	mappedFile.close();
+
+	std::filesystem::rename(temporaryFilename, filename, errorCode);
+	if (!errorCode) return true;
+
+	std::filesystem::remove(temporaryFilename, errorCode);
+
+	return false;
+}
+
+/// [Protected methods]
+
+uint64_t MeshCache::hashHeader(const Header& header, const ComponentEntry* components)
+{
+	const uint64_t headerHash = HashUtilities::fnv1a(&header, offsetof(Header, _headerHash));
+	return HashUtilities::fnv1a(components, size_t(header._numComponents) * sizeof(ComponentEntry), headerHash);
+}
@@ -0,0 +1,152 @@
+#pragma once
+
+#include "Geometry/3D/AABB.h"
+#include "Graphics/Core/Model3D.h"
+#include "Utilities/MappedFile.h"
+
+/**
+*	@file MeshCache.h
+*	@authors Alfonso Lpez Ruiz (alr00048@red.ujaen.es)
+*	@date 19/10/2026
+*/
+
+/**
+*	@brief Binary cache of a mesh which is memory-mapped and read in place. It stores positions and indices of every component in 
+*	aligned streams, plus optional normals and texture coordinates. The header identifies the source file so that stale entries are discarded.
+*/
+class MeshCache
+{
+public:
+	enum Stream : uint32_t { NORMALS = 1 << 0, TEXTURE_COORDINATES = 1 << 1 };
+
+protected:
+	inline static const char		MAGIC[4] = { 'M', 'S', 'H', 'C' };
+	inline static const uint32_t	VERSION = 2;
+	inline static const size_t		ALIGNMENT = 64;			//!< Alignment of every stream within the file
+
+	/**
+	*	@brief Header of a cache file, followed by the table of components and their streams.
+	*/
+	struct Header
+	{
+		char		_magic[4];
+		uint32_t	_version;
+		uint64_t	_sourceHash;						//!< Hash of the path, size and modification time of the source file
+		uint64_t	_fileSize;
+		uint32_t	_numComponents;
+		uint32_t	_streams;							//!< Optional streams, as a combination of Stream flags
+		vec3		_min, _max;
+		uint64_t	_dataHash;							//!< Hash of the streams, i.e., every byte which follows the table of components
+		uint64_t	_headerHash;						//!< Hash of the previous fields and the table of components
+	};
+
+	/**
+	*	@brief Location of the streams of a component. Offsets are given in bytes from the beginning of the file, and are zero for missing streams.
+	*/
+	struct ComponentEntry
+	{
+		uint64_t	_numVertices, _numFaces;
+		uint64_t	_positionOffset, _faceOffset, _normalOffset, _textCoordOffset;
+		vec3		_min, _max;
+	};
+
+protected:
+	const ComponentEntry*	_components;				//!< Table of components within the mapped file
+	const Header*			_header;					//!< Header within the mapped file
+	MappedFile				_mappedFile;				//!< Mapped cache file
+
+protected:
+	/**
+	*	@return Hash of the header fields which precede it and of the table of components.
+	*/
+	static uint64_t hashHeader(const Header& header, const ComponentEntry* components);
+
+	/**
+	*	@return Pointer to the given offset of the mapped file.
+	*/
+	template<typename T>
+	const T* at(uint64_t offset) const { return offset ? reinterpret_cast<const T*>(static_cast<const char*>(_mappedFile.data()) + offset) : nullptr; }
+
+public:
+	/**
+	*	@brief Constructor.
+	*/
+	MeshCache();
+
+	/**
+	*	@brief Invalid copy constructor.
+	*/
+	MeshCache(const MeshCache& meshCache) = delete;
+
+	/**
+	*	@brief Destructor. Unmaps the file.
+	*/
+	virtual ~MeshCache();
+
+	/**
+	*	@brief Unmaps the file.
+	*/
+	void close();
+
+	/**
+	*	@return Bounding box of the whole mesh.
+	*/
+	AABB getAABB() const { return AABB(_header->_min, _header->_max); }
+
+	/**
+	*	@return Bounding box of a component.
+	*/
+	AABB getAABB(unsigned component) const { return AABB(_components[component]._min, _components[component]._max); }
+
+	/**
+	*	@return Vertex indices of a component, mapped in place.
+	*/
+	const uvec3* getFaces(unsigned component) const { return this->at<uvec3>(_components[component]._faceOffset); }
+
+	/**
+	*	@return Normals of a component, mapped in place, or nullptr if they were not stored.
+	*/
+	const vec3* getNormals(unsigned component) const { return this->at<vec3>(_components[component]._normalOffset); }
+
+	/**
+	*	@return Number of components.
+	*/
+	unsigned getNumComponents() const { return _header ? _header->_numComponents : 0; }
+
+	/**
+	*	@return Number of faces of a component.
+	*/
+	size_t getNumFaces(unsigned component) const { return _components[component]._numFaces; }
+
+	/**
+	*	@return Number of vertices of a component.
+	*/
+	size_t getNumVertices(unsigned component) const { return _components[component]._numVertices; }
+
+	/**
+	*	@return Vertex positions of a component, mapped in place.
+	*/
+	const vec3* getPositions(unsigned component) const { return this->at<vec3>(_components[component]._positionOffset); }
+
+	/**
+	*	@return Hash which identifies the current version of a source file, or zero if it does not exist.
+	*/
+	static uint64_t getSourceHash(const std::string& sourceFile);
+
+	/**
+	*	@return Texture coordinates of a component, mapped in place, or nullptr if they were not stored.
+	*/
+	const vec2* getTextCoords(unsigned component) const { return this->at<vec2>(_components[component]._textCoordOffset); }
+
+	/**
+	*	@brief Maps a cache file and validates its header and layout.
+	*	@param sourceHash Expected hash of the source file, or zero to accept any entry.
+	*	@return False if the file is missing, belongs to another version of the format or of the source file, or is corrupt (either its header or its streams).
+	*/
+	bool open(const std::string& filename, uint64_t sourceHash);
+
+	/**
+	*	@brief Writes the positions and indices of the given components, together with the requested optional streams.
+	*/
+	static bool write(const std::string& filename, uint64_t sourceHash, const std::vector<Model3D::ModelComponent*>& components, const AABB& aabb, uint32_t streams = 0);
+};
@@ -0,0 +1,108 @@
+#include "stdafx.h"
+#include "OccupancyPyramid.h"
+
+/// [Public methods]
+
+void OccupancyPyramid::build(const RegularGrid::CellGrid* grid, const uvec3& numDivs, const AABB& aabb)
+{
+	_aabb = aabb;
+	_dimensions = { numDivs };
+	_occupancy.resize(size_t(numDivs.x) * numDivs.y * numDivs.z);
+	_counts.clear();
+
+#pragma omp parallel for
+	for (int64_t cellIdx = 0; cellIdx < int64_t(_occupancy.size()); ++cellIdx)
+		_occupancy[cellIdx] = grid[cellIdx]._value != VOXEL_EMPTY;
+
+	// Each level sums the counts of its (up to) eight children
+	while (glm::any(glm::greaterThan(_dimensions.back(), uvec3(1))))
+	{
+		const unsigned level = unsigned(_dimensions.size());
+		const uvec3 dimensions = (_dimensions.back() + 1u) / 2u;
+		std::vector<uint32_t> counts(size_t(dimensions.x) * dimensions.y * dimensions.z);
+
+#pragma omp parallel for
+		for (int x = 0; x < dimensions.x; ++x)
+		{
+			for (unsigned y = 0; y < dimensions.y; ++y)
+			{
+				for (unsigned z = 0; z < dimensions.z; ++z)
+				{
+					const uvec3 firstChild = uvec3(x, y, z) * 2u, lastChild = glm::min(firstChild + 1u, _dimensions.back() - 1u);
+					uint32_t count = 0;
+
+					for (unsigned childX = firstChild.x; childX <= lastChild.x; ++childX)
+						for (unsigned childY = firstChild.y; childY <= lastChild.y; ++childY)
+							for (unsigned childZ = firstChild.z; childZ <= lastChild.z; ++childZ)
+								count += this->getCount(level - 1, uvec3(childX, childY, childZ));
+
+					counts[RegularGrid::getPositionIndex(x, y, z, dimensions)] = count;
+				}
+			}
+		}
+
+		_dimensions.push_back(dimensions);
+		_counts.push_back(std::move(counts));
+	}
+}
+
+void OccupancyPyramid::instantiate(RegularGrid::CellGrid* grid, const uvec3& numDivs, FractureParameters::DownsamplingType downsamplingType) const
+{
+	if (_dimensions.empty()) return;
+
+	// Finest level which is at least as dense as the target grid
+	unsigned level = 0;
+	while (level + 1 < _dimensions.size() && glm::all(glm::greaterThanEqual(_dimensions[level + 1], numDivs))) ++level;
+
+	const uvec3 sourceDims = _dimensions[level];
+
+#pragma omp parallel for
+	for (int x = 0; x < numDivs.x; ++x)
+	{
+		for (unsigned y = 0; y < numDivs.y; ++y)
+		{
+			for (unsigned z = 0; z < numDivs.z; ++z)
+			{
+				// Source cells overlapped by the target voxel
+				const uvec3 target = uvec3(x, y, z);
+				const uvec3 firstCell = glm::min(uvec3((glm::u64vec3(target) * glm::u64vec3(sourceDims)) / glm::u64vec3(numDivs)), sourceDims - 1u);
+				const uvec3 lastCell = glm::max(firstCell, uvec3((glm::u64vec3(target + 1u) * glm::u64vec3(sourceDims) + glm::u64vec3(numDivs) - 1ull) / glm::u64vec3(numDivs)) - 1u);
+				uint64_t count = 0, size = 0;
+
+				for (unsigned cellX = firstCell.x; cellX <= glm::min(lastCell.x, sourceDims.x - 1); ++cellX)
+				{
+					for (unsigned cellY = firstCell.y; cellY <= glm::min(lastCell.y, sourceDims.y - 1); ++cellY)
+					{
+						for (unsigned cellZ = firstCell.z; cellZ <= glm::min(lastCell.z, sourceDims.z - 1); ++cellZ)
+						{
+							count += this->getCount(level, uvec3(cellX, cellY, cellZ));
+							size += this->getCellSize(level, uvec3(cellX, cellY, cellZ));
+						}
+					}
+				}
+
+				const bool occupied = downsamplingType == FractureParameters::MAJORITY ? count * 2 >= size && count > 0 : count > 0;
+				if (occupied) grid[RegularGrid::getPositionIndex(x, y, z, numDivs)]._value = VOXEL_FREE;
+			}
+		}
+	}
+}
+
+/// [Protected methods]
+
+uint32_t OccupancyPyramid::getCellSize(unsigned level, const uvec3& cell) const
+{
+	const uvec3 first = cell << level;
+	const uvec3 last = glm::min(first + (1u << level), _dimensions[0]);
+	const uvec3 size = last - first;
+
+	return size.x * size.y * size.z;
+}
+
+uint32_t OccupancyPyramid::getCount(unsigned level, const uvec3& cell) const
+{
+	if (level == 0)
+		return _occupancy[RegularGrid::getPositionIndex(cell.x, cell.y, cell.z, _dimensions[0])];
+
+	return _counts[level - 1][RegularGrid::getPositionIndex(cell.x, cell.y, cell.z, _dimensions[level])];
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "DataStructures/RegularGrid.h"
+#include "Geometry/3D/AABB.h"
+
+/**
+*	@file OccupancyPyramid.h
+*	@authors Alfonso Lpez Ruiz (alr00048@red.ujaen.es)
+*	@date 19/10/2026
+*/
+
+/**
+*	@brief Mip pyramid of occupancy (full, 1/2, 1/4, ...) built from a single voxelization. Each coarse cell keeps the number of occupied 
+*	voxels of the finest grid it covers, so that both conservative and majority downsampling can be applied afterwards, and a grid of any 
+*	resolution can be instantiated over the same bounding box without voxelizing again.
+*/
+class OccupancyPyramid
+{
+protected:
+	AABB								_aabb;			//!< Bounding box of the voxelization
+	std::vector<uvec3>					_dimensions;	//!< Dimensions of each level
+	std::vector<uint8_t>				_occupancy;		//!< Finest level, one byte per voxel
+	std::vector<std::vector<uint32_t>>	_counts;		//!< Coarser levels, number of occupied voxels of the finest level per cell
+
+protected:
+	/**
+	*	@return Number of finest voxels covered by a cell of the given level.
+	*/
+	uint32_t getCellSize(unsigned level, const uvec3& cell) const;
+
+	/**
+	*	@return Number of occupied finest voxels within a cell of the given level.
+	*/
+	uint32_t getCount(unsigned level, const uvec3& cell) const;
+
+public:
+	/**
+	*	@brief Constructor of an empty pyramid.
+	*/
+	OccupancyPyramid() {}
+
+	/**
+	*	@brief Builds every level from the non-empty voxels of a grid (layout x * Y * Z + y * Z + z).
+	*/
+	void build(const RegularGrid::CellGrid* grid, const uvec3& numDivs, const AABB& aabb);
+
+	/**
+	*	@return Bounding box of the voxelization.
+	*/
+	AABB getAABB() const { return _aabb; }
+
+	/**
+	*	@return Dimensions of a level, being 0 the finest one.
+	*/
+	uvec3 getDimensions(unsigned level) const { return _dimensions[level]; }
+
+	/**
+	*	@return Number of levels.
+	*/
+	unsigned getNumLevels() const { return unsigned(_dimensions.size()); }
+
+	/**
+	*	@brief Resamples the pyramid into a grid with the given dimensions, using the finest level which is at least as dense. 
+	*	Occupied voxels are set to VOXEL_FREE, whereas the rest are left untouched.
+	*/
+	void instantiate(RegularGrid::CellGrid* grid, const uvec3& numDivs, FractureParameters::DownsamplingType downsamplingType) const;
+};
+
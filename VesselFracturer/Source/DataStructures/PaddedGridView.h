@@ -0,0 +1,43 @@
+#pragma once
+
+#include "DataStructures/RegularGrid.h"
+
+/**
+*	@file PaddedGridView.h
+*	@authors Alfonso Lpez Ruiz (alr00048@red.ujaen.es)
+*	@date 19/10/2026
+*/
+
+/**
+*	@brief Read-only view of the labels of a regular grid surrounded by a border of one free voxel. The border is never stored: reads 
+*	outside the grid are answered as VOXEL_FREE on the fly, so meshers can work with the padded grid without copying it.
+*/
+class PaddedGridView
+{
+protected:
+	const RegularGrid::CellGrid*	_grid;				//!< Labels of the grid, layout x * Y * Z + y * Z + z
+	uvec3							_numDivs;			//!< Dimensions of the grid, without border
+
+public:
+	/**
+	*	@brief Constructor.
+	*/
+	PaddedGridView(const RegularGrid::CellGrid* grid, const uvec3& numDivs) : _grid(grid), _numDivs(numDivs) {}
+
+	/**
+	*	@return Value at a position of the padded grid, where (1, 1, 1) is the first voxel of the grid.
+	*/
+	uint16_t at(int x, int y, int z) const
+	{
+		if (unsigned(x - 1) >= _numDivs.x || unsigned(y - 1) >= _numDivs.y || unsigned(z - 1) >= _numDivs.z)
+			return VOXEL_FREE;
+
+		return _grid[(size_t(x - 1) * _numDivs.y + (y - 1)) * _numDivs.z + (z - 1)]._value;
+	}
+
+	/**
+	*	@return Dimensions of the padded grid.
+	*/
+	uvec3 getNumSubdivisions() const { return _numDivs + uvec3(2); }
+};
+
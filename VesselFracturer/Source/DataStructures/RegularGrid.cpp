@@ -1,28 +1,37 @@
 #include "stdafx.h"
 #include "RegularGrid.h"
 
+#include "DataStructures/OccupancyPyramid.h"
+#include "DataStructures/PaddedGridView.h"
+#include "DataStructures/VoxelizationCache.h"
 #include "Geometry/3D/AABB.h"
 #include "Graphics/Core/AssimpModel.h"
 #include "Graphics/Core/MarchingCubes.h"
+#include "Graphics/Core/MarchingCubesCPU.h"
 #include "Graphics/Core/ShaderList.h"
+#include "Graphics/Core/SurfaceNets.h"
+#include "Graphics/Core/SurfaceVoxelizer.h"
 #include "Graphics/Core/Tetravoxelizer.h"
+#include "Graphics/Core/TetravoxelizerCPU.h"
+#include "Graphics/Core/WindingNumberVoxelizer.h"
 #include "tinyply.h"
 #include "Utilities/ChronoUtilities.h"
+#include "Utilities/FileManagement.h"
 #include "VoxWriter.h"
 
 /// Public methods
 
-RegularGrid::RegularGrid(const AABB& aabb, const ivec3& subdivisions) :
+RegularGrid::RegularGrid(const AABB& aabb, const ivec3& subdivisions, bool outOfCore) :
 	_aabb(aabb), _marchingCubes(nullptr), _numDivs(subdivisions)
 {
+	this->buildGrid(outOfCore);
 	this->setAABB(aabb, _numDivs);
-	this->buildGrid();
 	this->getComputeShaders();
 }
 
-RegularGrid::RegularGrid(const ivec3& subdivisions) : _cellSize(.0f), _marchingCubes(nullptr), _numDivs(subdivisions)
+RegularGrid::RegularGrid(const ivec3& subdivisions, bool outOfCore) : _cellSize(.0f), _marchingCubes(nullptr), _numDivs(subdivisions)
 {
-	this->buildGrid();
+	this->buildGrid(outOfCore);
 	this->getComputeShaders();
 }
 
@@ -33,6 +42,11 @@ RegularGrid::~RegularGrid()
 	ComputeShader::deleteBuffer(_ssbo);
 }
 
+void RegularGrid::buildOccupancyPyramid(OccupancyPyramid& pyramid)
+{
+	pyramid.build(_grid.data(), _numDivs, _aabb);
+}
+
 unsigned RegularGrid::calculateMaxQuadrantOccupancy(unsigned subdivisions)
 {
 	uvec3 numDivs = this->getNumSubdivisions();
@@ -149,7 +163,7 @@ void RegularGrid::exportGrid()
 	vox::VoxWriter vox;
 	for (int x = 0; x < _numDivs.x; ++x)
 	{
-		unsigned positionIndex;
+		size_t positionIndex;
 
 		for (int y = 0; y < _numDivs.y; ++y)
 		{
@@ -166,32 +180,101 @@ void RegularGrid::exportGrid()
 	vox.PrintStats();
 }
 
-void RegularGrid::fill(Model3D::ModelComponent* modelComponent)
+void RegularGrid::fill(Model3D::ModelComponent* modelComponent, const FractureParameters& fractParameters)
 {
-	Tetravoxelizer tetravoxelizer;
-	tetravoxelizer.initialize(_numDivs);
-	tetravoxelizer.initializeModel(modelComponent->_geometry, modelComponent->_topology, _aabb);
-	tetravoxelizer.compute(_voxelOpenGL);
-	tetravoxelizer.deleteModelResources();
-	tetravoxelizer.deleteResources();
+	// Hashing the mesh is not free, hence the cache is only built when a folder is given
+	std::unique_ptr<VoxelizationCache> cache;
+	if (!fractParameters._voxelizationCacheFolder.empty())
+	{
+		cache = std::make_unique<VoxelizationCache>(fractParameters._voxelizationCacheFolder, modelComponent, _aabb, _numDivs, fractParameters._voxelizationType);
+		if (cache->load(_grid.data()))
+		{
+			this->updateSSBO();
+			return;
+		}
+	}
 
-#pragma omp parallel for
-	for (int y = 0; y < _numDivs.y; ++y)
+	const size_t numCells = size_t(_numDivs.x) * _numDivs.y * _numDivs.z;
+	if (_grid.isMapped())
+		_voxelOpenGL.allocate(this->getMappedFilename("voxelization"), numCells);
+	else
+		_voxelOpenGL.allocate(numCells);
+
+	if (fractParameters._voxelizationType == FractureParameters::WINDING_NUMBER)
+	{
+		WindingNumberVoxelizer windingNumberVoxelizer;
+		windingNumberVoxelizer.initialize(_numDivs);
+		windingNumberVoxelizer.initializeModel(modelComponent->_geometry, modelComponent->_topology, _aabb);
+		windingNumberVoxelizer.compute(_voxelOpenGL.data());
+	}
+	else if (fractParameters._voxelizationType == FractureParameters::SURFACE_FLOOD)
 	{
-		glm::uint positionIndex;
+		SurfaceVoxelizer surfaceVoxelizer;
+		surfaceVoxelizer.initialize(_numDivs);
+		surfaceVoxelizer.initializeModel(modelComponent->_geometry, modelComponent->_topology, _aabb);
+		surfaceVoxelizer.compute(_voxelOpenGL.data());
+	}
+	else if (fractParameters._voxelizationType == FractureParameters::TETRAVOXELIZER_CPU)
+	{
+		TetravoxelizerCPU tetravoxelizer;
+		tetravoxelizer.initialize(_numDivs);
+		tetravoxelizer.initializeModel(modelComponent->_geometry, modelComponent->_topology, _aabb);
+		tetravoxelizer.compute(_voxelOpenGL.data());
+	}
+	else
+	{
+		Tetravoxelizer tetravoxelizer;
+		tetravoxelizer.initialize(_numDivs);
+		tetravoxelizer.initializeModel(modelComponent->_geometry, modelComponent->_topology, _aabb);
+		tetravoxelizer.compute(_voxelOpenGL.data());
+		tetravoxelizer.deleteModelResources();
+		tetravoxelizer.deleteResources();
+	}
+
+	// The voxelization is y-major (y, z, x) whereas the grid is x-major (x, y, z). Out-of-core grids are filled by tiles of y-slabs, so 
+	// that each tile reads a contiguous range of the voxelization and writes one contiguous run of every x-slab of the grid
+	const size_t slabSize = size_t(_numDivs.x) * _numDivs.z;
+	const unsigned slabsPerTile = _grid.isMapped() ? unsigned(std::max(size_t(1), MAPPED_TILE_SIZE / (slabSize * sizeof(CellGrid)))) : _numDivs.y;
+
+	for (unsigned yTile = 0; yTile < _numDivs.y; yTile += slabsPerTile)
+	{
+		const unsigned yEnd = std::min(yTile + slabsPerTile, _numDivs.y);
+		_voxelOpenGL.prefetch(yTile * slabSize, (yEnd - yTile) * slabSize);
+
+#pragma omp parallel for
 		for (int x = 0; x < _numDivs.x; ++x)
 		{
-			for (int z = 0; z < _numDivs.z; ++z)
+			for (int y = yTile; y < yEnd; ++y)
 			{
-				positionIndex = y * _numDivs.x * _numDivs.z + z * _numDivs.x + x;
-				if (_voxelOpenGL[positionIndex] == 1)
+				for (int z = 0; z < _numDivs.z; ++z)
 				{
-					this->set(x, y, z, VOXEL_FREE);
+					if (_voxelOpenGL[(size_t(y) * _numDivs.z + z) * _numDivs.x + x] == 1)
+					{
+						this->set(x, y, z, VOXEL_FREE);
+					}
 				}
 			}
 		}
+
+		_voxelOpenGL.evict(yTile * slabSize, (yEnd - yTile) * slabSize);
+		if (_grid.isMapped())
+		{
+			for (unsigned x = 0; x < _numDivs.x; ++x)
+				_grid.evict(this->getPositionIndex(x, yTile, 0), size_t(yEnd - yTile) * _numDivs.z);
+		}
 	}
 
+	_voxelOpenGL.release();
+
+	if (cache) cache->save(_grid.data());
+
+	this->updateSSBO();
+}
+
+void RegularGrid::fill(const OccupancyPyramid& pyramid, FractureParameters::DownsamplingType downsamplingType)
+{
+	pyramid.instantiate(_grid.data(), _numDivs, downsamplingType);
+
 	this->updateSSBO();
 }
 
@@ -228,6 +311,79 @@ void RegularGrid::getAABBs(std::vector<AABB>& aabb)
 	}
 }
 
+void RegularGrid::getMergedAABBs(std::vector<AABB>& aabb, bool onlySurface)
+{
+	// Boxes are not merged across slabs so that each slab can be processed by a different thread. Slabs are cut along x and scanned 
+	// along z, the contiguous axis of the grid
+	const unsigned numSlabs = (_numDivs.x + MERGE_SLAB_SIZE - 1) / MERGE_SLAB_SIZE;
+	std::vector<std::vector<AABB>> slabAABBs(numSlabs);
+
+#pragma omp parallel for
+	for (int slabIdx = 0; slabIdx < numSlabs; ++slabIdx)
+	{
+		const unsigned minX = slabIdx * MERGE_SLAB_SIZE, maxX = std::min(minX + MERGE_SLAB_SIZE, _numDivs.x);
+		const unsigned slabWidth = maxX - minX;
+		std::vector<uint8_t> visited(size_t(slabWidth) * _numDivs.y * _numDivs.z, 0);
+
+		auto visitedIndex = [&](unsigned x, unsigned y, unsigned z) -> size_t { return (size_t(x - minX) * _numDivs.y + y) * _numDivs.z + z; };
+		auto canMerge = [&](unsigned x, unsigned y, unsigned z, uint16_t value) -> bool {
+			const uint16_t cellValue = _grid[this->getPositionIndex(x, y, z)]._value;
+			return !visited[visitedIndex(x, y, z)] && cellValue != VOXEL_EMPTY && this->unmask(cellValue) == value;
+		};
+
+		for (unsigned x = minX; x < maxX; ++x)
+		{
+			for (unsigned y = 0; y < _numDivs.y; ++y)
+			{
+				for (unsigned z = 0; z < _numDivs.z; ++z)
+				{
+					const uint16_t cellValue = _grid[this->getPositionIndex(x, y, z)]._value;
+					if (cellValue == VOXEL_EMPTY || visited[visitedIndex(x, y, z)])
+						continue;
+
+					const uint16_t value = this->unmask(cellValue);
+					uvec3 boxMax(x + 1, y + 1, z + 1);
+
+					// Extend along z
+					while (boxMax.z < _numDivs.z && canMerge(x, y, boxMax.z, value))
+						++boxMax.z;
+
+					// Extend along y while the whole row matches
+					bool extend = true;
+					while (extend && boxMax.y < _numDivs.y)
+					{
+						for (unsigned zRow = z; zRow < boxMax.z && extend; ++zRow)
+							extend = canMerge(x, boxMax.y, zRow, value);
+
+						if (extend) ++boxMax.y;
+					}
+
+					// Extend along x while the whole rectangle matches, never crossing the slab
+					extend = true;
+					while (extend && boxMax.x < maxX)
+					{
+						for (unsigned yRow = y; yRow < boxMax.y && extend; ++yRow)
+							for (unsigned zRow = z; zRow < boxMax.z && extend; ++zRow)
+								extend = canMerge(boxMax.x, yRow, zRow, value);
+
+						if (extend) ++boxMax.x;
+					}
+
+					for (unsigned xBox = x; xBox < boxMax.x; ++xBox)
+						for (unsigned yBox = y; yBox < boxMax.y; ++yBox)
+							std::fill_n(visited.begin() + visitedIndex(xBox, yBox, z), boxMax.z - z, 1);
+
+					if (!onlySurface || this->isExposed(uvec3(x, y, z), boxMax))
+						slabAABBs[slabIdx].push_back(AABB(_aabb.min() + _cellSize * vec3(x, y, z), _aabb.min() + _cellSize * vec3(boxMax)));
+				}
+			}
+		}
+	}
+
+	for (const std::vector<AABB>& slab : slabAABBs)
+		aabb.insert(aabb.end(), slab.begin(), slab.end());
+}
+
 void RegularGrid::insertPoint(const vec3& position, unsigned index)
 {
 	uvec3 gridIndex = getPositionIndex(position);
@@ -248,12 +404,26 @@ void RegularGrid::queryCluster(
 	const std::vector<Model3D::VertexGPUData>& vertices, const std::vector<Model3D::FaceGPUData>& faces, std::vector<float>& clusterIdx,
 	std::vector<unsigned>& boundaryFaces, std::vector<std::unordered_map<unsigned, float>>& faceClusterOccupancy)
 {
-	std::unordered_map<uint16_t, unsigned> values;
-	faceClusterOccupancy.resize(faces.size());
+	// The GPU needs a context and the whole grid in a buffer, which out-of-core grids are not meant for
+	if (!glfwGetCurrentContext() || _grid.isMapped())
+	{
+		this->queryClusterCPU(vertices, faces, clusterIdx, boundaryFaces, faceClusterOccupancy);
+		return;
+	}
 
+	std::unordered_map<uint16_t, unsigned> values;
 	size_t numFragments = this->countValues(values);
 	size_t numSamples = 1000;
 	size_t actualSize = numFragments * faces.size();
+
+	// Counters of faces x fragments which do not fit in a single buffer would take several passes, whereas the CPU is linear with the faces
+	if (actualSize > static_cast<size_t>(ComputeShader::getMaxSSBOSize(sizeof(GLuint))))
+	{
+		this->queryClusterCPU(vertices, faces, clusterIdx, boundaryFaces, faceClusterOccupancy, numSamples);
+		return;
+	}
+
+	faceClusterOccupancy.resize(faces.size());
 	size_t maxFaces = std::min(faces.size(), static_cast<size_t>(std::floor(ComputeShader::getMaxSSBOSize(sizeof(GLuint)) / numFragments)));
 	uvec3 numDivs = this->getNumSubdivisions();
 	unsigned numGroups = ComputeShader::getNumGroups(maxFaces * numSamples);
@@ -269,7 +439,7 @@ void RegularGrid::queryCluster(
 
 	const GLuint countSSBO = ComputeShader::setReadBuffer(count, maxFaces * numFragments, GL_DYNAMIC_DRAW);
 	const GLuint vertexSSBO = ComputeShader::setReadBuffer(vertices, GL_STATIC_DRAW);
-	const GLuint gridSSBO = ComputeShader::setReadBuffer(_grid, GL_STATIC_DRAW);
+	const GLuint gridSSBO = ComputeShader::setReadBuffer(_grid.data(), _grid.size(), GL_STATIC_DRAW);
 	const GLuint boundarySSBO = ComputeShader::setReadBuffer(boundary, maxFaces * numFragments, GL_DYNAMIC_DRAW);
 	const GLuint noiseSSBO = ComputeShader::setReadBuffer(noiseBuffer, GL_STATIC_DRAW);
 	const GLuint clusterSSBO = ComputeShader::setReadBuffer(clusterIdx, GL_DYNAMIC_DRAW);
@@ -350,7 +520,7 @@ void RegularGrid::queryCluster(std::vector<vec4>* points, std::vector<float>& cl
 
 	// Input data
 	const GLuint vertexSSBO = ComputeShader::setReadBuffer(*points, GL_STATIC_DRAW);
-	const GLuint gridSSBO = ComputeShader::setReadBuffer(_grid, GL_STATIC_DRAW);
+	const GLuint gridSSBO = ComputeShader::setReadBuffer(_grid.data(), _grid.size(), GL_STATIC_DRAW);
 	const GLuint clusterSSBO = ComputeShader::setWriteBuffer(float(), points->size(), GL_DYNAMIC_DRAW);
 
 	_assignVertexClusterShader->bindBuffers(std::vector<GLuint>{ vertexSSBO, gridSSBO, clusterSSBO });
@@ -367,11 +537,76 @@ void RegularGrid::queryCluster(std::vector<vec4>* points, std::vector<float>& cl
 	ComputeShader::deleteBuffers(std::vector<GLuint> { vertexSSBO, gridSSBO, clusterSSBO });
 }
 
+void RegularGrid::queryClusterCPU(
+	const std::vector<Model3D::VertexGPUData>& vertices, const std::vector<Model3D::FaceGPUData>& faces, std::vector<float>& clusterIdx,
+	std::vector<unsigned>& boundaryFaces, std::vector<std::unordered_map<unsigned, float>>& faceClusterOccupancy, unsigned numSamples)
+{
+	// Barycentric pattern shared by every triangle
+	std::vector<float> noiseBuffer;
+	std::vector<vec2> barycentric(numSamples);
+	this->fillNoiseBuffer(noiseBuffer, numSamples * 2);
+
+	for (unsigned sampleIdx = 0; sampleIdx < numSamples; ++sampleIdx)
+	{
+		barycentric[sampleIdx] = vec2(noiseBuffer[sampleIdx * 2 + 0], noiseBuffer[sampleIdx * 2 + 1]);
+		if (barycentric[sampleIdx].x + barycentric[sampleIdx].y >= 1.0f)
+			barycentric[sampleIdx] = vec2(1.0f) - barycentric[sampleIdx];
+	}
+
+	clusterIdx.resize(faces.size()); std::fill(clusterIdx.begin(), clusterIdx.end(), -1.0f);
+	faceClusterOccupancy.resize(faces.size());
+
+#pragma omp parallel
+	{
+		FragmentCounter counter;
+
+#pragma omp for
+		for (int faceIdx = 0; faceIdx < faces.size(); ++faceIdx)
+		{
+			const vec3 v1 = vertices[faces[faceIdx]._vertices.x]._position;
+			const vec3 u = vertices[faces[faceIdx]._vertices.y]._position - v1, v = vertices[faces[faceIdx]._vertices.z]._position - v1;
+
+			counter.clear();
+
+			for (const vec2& sample : barycentric)
+			{
+				const uvec3 gridIndex = this->getPositionIndex(v1 + u * sample.x + v * sample.y);
+				const uint16_t value = _grid[this->getPositionIndex(gridIndex.x, gridIndex.y, gridIndex.z)]._value;
+
+				if (this->unmask(value) > VOXEL_FREE)
+					counter.add(this->unmask(value) - (VOXEL_FREE + 1), value != this->unmask(value));
+			}
+
+			// Same criterion as the GPU version: the fragment with the highest count wins, ties are solved with the lowest index
+			unsigned maxIdx = 0;
+			for (unsigned idx = 0; idx < counter._size; ++idx)
+			{
+				faceClusterOccupancy[faceIdx][counter._fragment[idx]] = counter._count[idx] / static_cast<float>(numSamples);
+
+				if (counter._count[idx] > counter._count[maxIdx] || (counter._count[idx] == counter._count[maxIdx] && counter._fragment[idx] < counter._fragment[maxIdx]))
+					maxIdx = idx;
+			}
+
+			if (counter._size)
+				clusterIdx[faceIdx] = (counter._fragment[maxIdx] + 2.0f) * (counter._boundary[maxIdx] > 0 ? 1.0f : -1.0f);
+		}
+	}
+
+	for (int idx = 0; idx < clusterIdx.size(); ++idx)
+	{
+		if (clusterIdx[idx] < .0f)
+		{
+			boundaryFaces.push_back(idx);
+			clusterIdx[idx] = -clusterIdx[idx];
+		}
+	}
+}
+
 void RegularGrid::resetFilling()
 {
-	size_t numCells = _numDivs.x * _numDivs.y * _numDivs.z;
+	const size_t numCells = size_t(_numDivs.x) * _numDivs.y * _numDivs.z;
 #pragma omp parallel for
-	for (int idx = 0; idx < numCells; ++idx)
+	for (int64_t idx = 0; idx < int64_t(numCells); ++idx)
 		_grid[idx]._value = glm::clamp(_grid[idx]._value, uint16_t(VOXEL_EMPTY), uint16_t(VOXEL_FREE + 1));
 }
 
@@ -400,46 +635,76 @@ void RegularGrid::setAABB(const AABB& aabb, const ivec3& gridDims)
 
 std::vector<Model3D*> RegularGrid::toTriangleMesh(FractureParameters& fractParameters, std::vector<FragmentationProcedure::FragmentMetadata>& fragmentMetadata)
 {
-	std::vector<Model3D*> meshes;
-	std::unordered_map<uint16_t, unsigned> valuesSet;
 	std::vector<uint16_t> values;
-	unsigned globalCount = 0;
-
-	this->countValues(valuesSet);
-	meshes.resize(valuesSet.size());
+	std::vector<FragmentSurface> fragments;
+	const mat4 transformationMatrix = this->getMeshingValues(fractParameters, fragmentMetadata, values, fragments);
+	std::vector<Model3D*> meshes(values.size());
 
-	values.reserve(valuesSet.size());
-	fragmentMetadata.resize(valuesSet.size());
-	for (auto it = valuesSet.begin(); it != valuesSet.end(); )
+	if (fractParameters._meshingType == FractureParameters::MARCHING_CUBES_CPU || fractParameters._meshingType == FractureParameters::SURFACE_NETS)
 	{
-		fragmentMetadata[it->first - (VOXEL_FREE + 1)]._voxels = it->second;
+		// All the fragments are meshed within a single sweep
+		std::unique_ptr<MarchingCubesCPU> mesher;
+		if (fractParameters._meshingType == FractureParameters::SURFACE_NETS)
+			mesher = std::make_unique<SurfaceNets>(_numDivs);
+		else
+			mesher = std::make_unique<MarchingCubesCPU>(_numDivs);
 
-		globalCount += it->second;
-		values.push_back(std::move(valuesSet.extract(it++).key()));
+		std::vector<AssimpModel*> models = mesher->triangulateFields(PaddedGridView(_grid.data(), _numDivs), values, fractParameters, transformationMatrix);
+		std::copy(models.begin(), models.end(), meshes.begin());
+
+		return meshes;
 	}
 
-#pragma omp parallel for
-	for (int idx = 0; idx < values.size(); ++idx)
+	if (fractParameters._meshingType == FractureParameters::MARCHING_CUBES_SPARSE)
 	{
-		fragmentMetadata[idx]._id = idx;
-		fragmentMetadata[idx]._percentage = fragmentMetadata[idx]._voxels / static_cast<float>(globalCount);
-		fragmentMetadata[idx]._occupiedVoxels = globalCount;
-		fragmentMetadata[idx]._voxelizationSize = _numDivs;
+		// Only the cells around the surface of each fragment are visited
+		MarchingCubesCPU mesher(_numDivs);
+		std::vector<AssimpModel*> models = mesher.triangulateActiveCells(PaddedGridView(_grid.data(), _numDivs), fragments, fractParameters, transformationMatrix);
+		std::copy(models.begin(), models.end(), meshes.begin());
+
+		return meshes;
 	}
 
-	std::sort(values.begin(), values.end());
+	for (int idx = 0; idx < values.size(); ++idx)
+		meshes[idx] = _marchingCubes->triangulateFieldGPU(_ssbo, values[idx], fractParameters, transformationMatrix);
 
-	if (_marchingCubes)
-		_marchingCubes->setGrid(*this);
+	return meshes;
+}
 
-	vec3 scale = (_aabb.size()) / vec3(_numDivs);
-	vec3 minPoint = _aabb.min();
-	mat4 transformationMatrix = glm::translate(glm::mat4(1.0f), -vec3(1.0f) * scale) * glm::translate(glm::mat4(1.0f), minPoint) * glm::scale(glm::mat4(1.0f), scale);
+bool RegularGrid::toTriangleMesh(FractureParameters& fractParameters, std::vector<FragmentationProcedure::FragmentMetadata>& fragmentMetadata, const std::function<MeshSink*(unsigned)>& getSink)
+{
+	std::vector<uint16_t> values;
+	std::vector<FragmentSurface> fragments;
+	const mat4 transformationMatrix = this->getMeshingValues(fractParameters, fragmentMetadata, values, fragments);
 
+	std::vector<MeshSink*> sinks(values.size());
+	for (unsigned idx = 0; idx < values.size(); ++idx)
+		sinks[idx] = getSink(idx);
+
+	if (fractParameters._meshingType == FractureParameters::MARCHING_CUBES_CPU || fractParameters._meshingType == FractureParameters::SURFACE_NETS)
+	{
+		std::unique_ptr<MarchingCubesCPU> mesher;
+		if (fractParameters._meshingType == FractureParameters::SURFACE_NETS)
+			mesher = std::make_unique<SurfaceNets>(_numDivs);
+		else
+			mesher = std::make_unique<MarchingCubesCPU>(_numDivs);
+
+		return mesher->triangulateFields(PaddedGridView(_grid.data(), _numDivs), values, fractParameters, transformationMatrix, sinks);
+	}
+
+	if (fractParameters._meshingType == FractureParameters::MARCHING_CUBES_SPARSE)
+		return MarchingCubesCPU(_numDivs).triangulateActiveCells(PaddedGridView(_grid.data(), _numDivs), fragments, transformationMatrix, sinks);
+
+	// GPU meshes are read back one at a time, so only a single model is alive at once
+	bool success = true;
 	for (int idx = 0; idx < values.size(); ++idx)
-		meshes[idx] = _marchingCubes->triangulateFieldGPU(_ssbo, values[idx], fractParameters, transformationMatrix);
+	{
+		AssimpModel* model = _marchingCubes->triangulateFieldGPU(_ssbo, values[idx], fractParameters, transformationMatrix);
+		success &= sinks[idx] && model->write(*sinks[idx]);
+		delete model;
+	}
 
-	return meshes;
+	return success;
 }
 
 void RegularGrid::undoMask()
@@ -519,7 +784,7 @@ bool RegularGrid::isEmpty(int x, int y, int z) const
 
 size_t RegularGrid::length() const
 {
-	return _numDivs.x * _numDivs.y * _numDivs.z;
+	return size_t(_numDivs.x) * _numDivs.y * _numDivs.z;
 }
 
 void RegularGrid::set(int x, int y, int z, uint8_t i)
@@ -529,27 +794,30 @@ void RegularGrid::set(int x, int y, int z, uint8_t i)
 
 /// Protected methods	
 
-void RegularGrid::buildGrid()
+void RegularGrid::buildGrid(bool outOfCore)
 {
-	_grid = std::vector<CellGrid>(_numDivs.x * _numDivs.y * _numDivs.z, CellGrid());
+	const size_t numCells = size_t(_numDivs.x) * _numDivs.y * _numDivs.z;
+	if (outOfCore)
+		_grid.allocate(this->getMappedFilename("grid"), numCells, CellGrid());
+	else
+		_grid.allocate(numCells, CellGrid());
+
 	_ssbo = ComputeShader::setReadBuffer(_grid.data(), _grid.size(), GL_DYNAMIC_DRAW);
 	_countSSBO = ComputeShader::setWriteBuffer(GLuint(), _numDivs.x * _numDivs.y * _numDivs.z, GL_DYNAMIC_DRAW);
-	_voxelOpenGL = std::vector<unsigned char>(_numDivs.x * _numDivs.y * _numDivs.z, 0);
 }
 
 void RegularGrid::cleanGrid()
 {
-	unsigned numCells = _numDivs.x * _numDivs.y * _numDivs.z;
+	const size_t numCells = size_t(_numDivs.x) * _numDivs.y * _numDivs.z;
 	//_grid = std::vector<CellGrid>(_numDivs.x * _numDivs.y * _numDivs.z);
 	std::fill(_grid.begin(), _grid.begin() + numCells, CellGrid());
-	std::fill(_voxelOpenGL.begin(), _voxelOpenGL.begin() + numCells, 0);
 
 	ComputeShader::updateReadBufferSubset(_ssbo, _grid.data(), 0, numCells);
 }
 
 size_t RegularGrid::countValues(std::unordered_map<uint16_t, unsigned>& values)
 {
-	unsigned index;
+	size_t index;
 	uint16_t value;
 	auto it = values.begin();
 
@@ -573,6 +841,54 @@ size_t RegularGrid::countValues(std::unordered_map<uint16_t, unsigned>& values)
 	return values.size();
 }
 
+mat4 RegularGrid::getMeshingValues(FractureParameters& fractParameters, std::vector<FragmentationProcedure::FragmentMetadata>& fragmentMetadata, std::vector<uint16_t>& values, std::vector<FragmentSurface>& fragments)
+{
+	std::unordered_map<uint16_t, unsigned> valuesSet;
+	unsigned globalCount = 0;
+
+	if (fractParameters._meshingType == FractureParameters::MARCHING_CUBES_SPARSE)
+	{
+		// Voxel counts come from the same sweep which gathers the active cells
+		this->getFragmentSurfaces(fragments);
+		for (const FragmentSurface& fragment : fragments)
+			valuesSet[fragment._value] = fragment._numVoxels;
+	}
+	else
+		this->countValues(valuesSet);
+
+	values.reserve(valuesSet.size());
+	fragmentMetadata.resize(valuesSet.size());
+	for (auto it = valuesSet.begin(); it != valuesSet.end(); )
+	{
+		fragmentMetadata[it->first - (VOXEL_FREE + 1)]._voxels = it->second;
+
+		globalCount += it->second;
+		values.push_back(std::move(valuesSet.extract(it++).key()));
+	}
+
+#pragma omp parallel for
+	for (int idx = 0; idx < values.size(); ++idx)
+	{
+		fragmentMetadata[idx]._id = idx;
+		fragmentMetadata[idx]._percentage = fragmentMetadata[idx]._voxels / static_cast<float>(globalCount);
+		fragmentMetadata[idx]._occupiedVoxels = globalCount;
+		fragmentMetadata[idx]._voxelizationSize = _numDivs;
+	}
+
+	std::sort(values.begin(), values.end());
+
+	vec3 scale = (_aabb.size()) / vec3(_numDivs);
+	vec3 minPoint = _aabb.min();
+
+	return glm::translate(glm::mat4(1.0f), -vec3(1.0f) * scale) * glm::translate(glm::mat4(1.0f), minPoint) * glm::scale(glm::mat4(1.0f), scale);
+}
+
+std::string RegularGrid::getMappedFilename(const std::string& buffer) const
+{
+	const std::filesystem::path folder = std::filesystem::temp_directory_path();
+	return (folder / (buffer + "_" + FileManagement::getUniqueSuffix() + ".map")).string();
+}
+
 void RegularGrid::getComputeShaders()
 {
 	_assignVertexClusterShader = ShaderList::getInstance()->getComputeShader(ShaderEnum::ASSIGN_VERTEX_CLUSTER);
@@ -584,6 +900,84 @@ void RegularGrid::getComputeShaders()
 	_undoMaskShader = ShaderList::getInstance()->getComputeShader(ShaderEnum::UNDO_MASK_SHADER);
 }
 
+void RegularGrid::getFragmentSurfaces(std::vector<FragmentSurface>& fragments)
+{
+	const ivec3 faceNeighbours[6] = { ivec3(-1, 0, 0), ivec3(1, 0, 0), ivec3(0, -1, 0), ivec3(0, 1, 0), ivec3(0, 0, -1), ivec3(0, 0, 1) };
+	const glm::u64vec3 paddedDivs = glm::u64vec3(_numDivs) + glm::u64vec3(2);
+	const int numSlabs = int((_numDivs.x + SURFACE_SLAB_SIZE - 1) / SURFACE_SLAB_SIZE);
+	std::vector<std::unordered_map<uint16_t, FragmentSurface>> slabFragments(numSlabs);
+
+#pragma omp parallel for schedule(dynamic)
+	for (int slabIdx = 0; slabIdx < numSlabs; ++slabIdx)
+	{
+		const unsigned firstX = slabIdx * SURFACE_SLAB_SIZE, lastX = std::min(firstX + SURFACE_SLAB_SIZE, _numDivs.x);
+
+		for (unsigned x = firstX; x < lastX; ++x)
+			for (unsigned y = 0; y < _numDivs.y; ++y)
+				for (unsigned z = 0; z < _numDivs.z; ++z)
+				{
+					if (_grid[this->getPositionIndex(x, y, z)]._value <= VOXEL_FREE)
+						continue;
+
+					const uint16_t value = this->unmask(_grid[this->getPositionIndex(x, y, z)]._value);
+					const uvec3 voxel = uvec3(x, y, z);
+					FragmentSurface& fragment = slabFragments[slabIdx][value];
+
+					fragment._value = value;
+					++fragment._numVoxels;
+					fragment._min = glm::min(fragment._min, voxel);
+					fragment._max = glm::max(fragment._max, voxel);
+
+					bool isSurface = false;
+					for (int neighbourIdx = 0; neighbourIdx < 6 && !isSurface; ++neighbourIdx)
+					{
+						const ivec3 neighbour = ivec3(voxel) + faceNeighbours[neighbourIdx];
+						isSurface = glm::any(glm::lessThan(neighbour, ivec3(0))) || glm::any(glm::greaterThanEqual(neighbour, ivec3(_numDivs))) ||
+							this->unmask(_grid[this->getPositionIndex(neighbour.x, neighbour.y, neighbour.z)]._value) != value;
+					}
+
+					if (!isSurface) continue;
+
+					// Voxel (x, y, z) is the padded corner (x + 1, y + 1, z + 1), shared by the cells from (x + 1, y, z) to (x + 2, y + 1, z + 1)
+					for (unsigned dx = 1; dx <= 2; ++dx)
+						for (unsigned dy = 0; dy <= 1; ++dy)
+							for (unsigned dz = 0; dz <= 1; ++dz)
+								fragment._activeCells.push_back(((x + dx) * paddedDivs.y + y + dy) * paddedDivs.z + z + dz);
+				}
+	}
+
+	// Slabs are merged in order, so that labels and cells remain sorted regardless of the number of threads
+	std::map<uint16_t, FragmentSurface> mergedFragments;
+	for (auto& localFragments : slabFragments)
+	{
+		for (auto& [value, localFragment] : localFragments)
+		{
+			FragmentSurface& fragment = mergedFragments[value];
+			fragment._value = value;
+			fragment._numVoxels += localFragment._numVoxels;
+			fragment._min = glm::min(fragment._min, localFragment._min);
+			fragment._max = glm::max(fragment._max, localFragment._max);
+			fragment._activeCells.insert(fragment._activeCells.end(), localFragment._activeCells.begin(), localFragment._activeCells.end());
+		}
+
+		localFragments.clear();
+	}
+
+	fragments.clear();
+	fragments.reserve(mergedFragments.size());
+	for (auto& mergedFragment : mergedFragments)
+		fragments.push_back(std::move(mergedFragment.second));
+
+#pragma omp parallel for schedule(dynamic)
+	for (int fragmentIdx = 0; fragmentIdx < fragments.size(); ++fragmentIdx)
+	{
+		std::vector<uint64_t>& activeCells = fragments[fragmentIdx]._activeCells;
+		std::sort(activeCells.begin(), activeCells.end());
+		activeCells.erase(std::unique(activeCells.begin(), activeCells.end()), activeCells.end());
+		activeCells.shrink_to_fit();
+	}
+}
+
 uvec3 RegularGrid::getPositionIndex(const vec3& position)
 {
 	unsigned x = (position.x - _aabb.min().x) / _cellSize.x, y = (position.y - _aabb.min().y) / _cellSize.y, z = (position.z - _aabb.min().z) / _cellSize.z;
@@ -592,9 +986,32 @@ uvec3 RegularGrid::getPositionIndex(const vec3& position)
 	return uvec3(glm::clamp(x, zeroUnsigned, _numDivs.x - 1), glm::clamp(y, zeroUnsigned, _numDivs.y - 1), glm::clamp(z, zeroUnsigned, _numDivs.z - 1));
 }
 
-unsigned RegularGrid::getPositionIndex(int x, int y, int z) const
+size_t RegularGrid::getPositionIndex(int x, int y, int z) const
 {
-	return x * _numDivs.y * _numDivs.z + y * _numDivs.z + z;
+	return (size_t(x) * _numDivs.y + y) * _numDivs.z + z;
+}
+
+bool RegularGrid::isExposed(const uvec3& min, const uvec3& max) const
+{
+	if (glm::any(glm::equal(min, uvec3(0))) || glm::any(glm::equal(max, _numDivs)))
+		return true;
+
+	for (unsigned y = min.y; y < max.y; ++y)
+		for (unsigned z = min.z; z < max.z; ++z)
+			if (this->isEmpty(min.x - 1, y, z) || this->isEmpty(max.x, y, z))
+				return true;
+
+	for (unsigned x = min.x; x < max.x; ++x)
+		for (unsigned z = min.z; z < max.z; ++z)
+			if (this->isEmpty(x, min.y - 1, z) || this->isEmpty(x, max.y, z))
+				return true;
+
+	for (unsigned x = min.x; x < max.x; ++x)
+		for (unsigned y = min.y; y < max.y; ++y)
+			if (this->isEmpty(x, y, min.z - 1) || this->isEmpty(x, y, max.z))
+				return true;
+
+	return false;
 }
 
 void RegularGrid::resetBuffer(GLuint ssbo, unsigned value, unsigned count)
@@ -611,7 +1028,7 @@ uint16_t RegularGrid::unmask(uint16_t value) const
 	return value & uint16_t(~(1 << MASK_POSITION));
 }
 
-unsigned RegularGrid::getPositionIndex(int x, int y, int z, const uvec3& numDivs)
+size_t RegularGrid::getPositionIndex(int x, int y, int z, const uvec3& numDivs)
 {
-	return x * numDivs.y * numDivs.z + y * numDivs.z + z;
+	return (size_t(x) * numDivs.y + y) * numDivs.z + z;
 }
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "DataStructures/GridStorage.h"
 #include "Graphics/Core/ComputeShader.h"
 #include "Graphics/Core/FractureParameters.h"
 #include "Graphics/Core/FragmentationProcedure.h"
@@ -7,6 +8,8 @@
 
 class AABB;
 class MarchingCubes;
+class MeshSink;
+class OccupancyPyramid;
 class Texture;
 class Voronoi;
 
@@ -33,11 +36,68 @@ public:
 		CellGrid(uint16_t value) : _value(value)/*, _boundary(0), _padding(.0f)*/ {}
 	};
 
+	/**
+	*	@brief Voxel bounds and surface of a fragment, gathered within a single sweep of the grid.
+	*/
+	struct FragmentSurface
+	{
+		uint16_t				_value;					//!< Fragment label
+		unsigned				_numVoxels;				//!< Number of voxels of the fragment
+		uvec3					_min, _max;				//!< Voxel bounds of the fragment, both inclusive
+		std::vector<uint64_t>	_activeCells;			//!< Sorted keys of the marching cubes cells around the surface voxels, given by their (+x, -y, -z) corner in the grid padded by one voxel
+
+		FragmentSurface() : _value(VOXEL_EMPTY), _numVoxels(0), _min(std::numeric_limits<unsigned>::max()), _max(0) {}
+	};
+
+protected:
+	/**
+	*	@brief Small fixed-capacity map which counts how many samples of a triangle fall into each fragment.
+	*/
+	struct FragmentCounter
+	{
+		static const unsigned CAPACITY = 32;
+
+		uint16_t	_fragment[CAPACITY];				//!< Fragment index
+		unsigned	_count[CAPACITY];					//!< Number of samples within the fragment
+		unsigned	_boundary[CAPACITY];				//!< Number of samples within boundary voxels of the fragment
+		unsigned	_size;								//!< Number of fragments found so far
+
+		FragmentCounter() : _size(0) {}
+
+		/**
+		*	@brief Registers a new sample. Samples from fragments beyond the capacity are discarded.
+		*/
+		void add(uint16_t fragment, bool boundary)
+		{
+			unsigned idx = 0;
+			while (idx < _size && _fragment[idx] != fragment) ++idx;
+
+			if (idx == _size)
+			{
+				if (_size == CAPACITY) return;
+
+				_fragment[_size] = fragment; _count[_size] = 0; _boundary[_size] = 0;
+				++_size;
+			}
+
+			++_count[idx];
+			_boundary[idx] += boundary;
+		}
+
+		/**
+		*	@brief Empties the map so that it can be reused.
+		*/
+		void clear() { _size = 0; }
+	};
+
 protected:
 	const unsigned MASK_POSITION = 15;
+	const unsigned MERGE_SLAB_SIZE = 16;				//!< Number of x layers processed by a single thread when merging voxels into boxes
+	const size_t MAPPED_TILE_SIZE = 1 << 26;			//!< Bytes of y-slabs which are paged in at once when the grid is memory-mapped
+	const unsigned SURFACE_SLAB_SIZE = 8;				//!< Number of x layers processed by a single thread when gathering fragment surfaces
 
 protected:
-	std::vector<CellGrid>		_grid;					//!< Color index of regular grid
+	GridStorage<CellGrid>		_grid;					//!< Color index of regular grid
 
 	AABB						_aabb;					//!< Bounding box of the scene
 	vec3						_cellSize;				//!< Size of each grid cell
@@ -45,7 +105,7 @@ protected:
 	MarchingCubes*				_marchingCubes;			//!< Marching cubes algorithm
 	uvec3						_numDivs;				//!< Number of subdivisions of space between mininum and maximum point
 	GLuint						_ssbo;					//!< GPU buffer to save the grid
-	std::vector<unsigned char>	_voxelOpenGL;			//!< CPU buffer to save the number of occupied voxels per cell	
+	GridStorage<unsigned char>	_voxelOpenGL;			//!< CPU buffer to save the number of occupied voxels per cell, only allocated while filling	
 
 	// Compute shaders
 	ComputeShader* _assignVertexClusterShader;			//!< Shader to assign a cluster to each vertex
@@ -58,9 +118,9 @@ protected:
 
 protected:
 	/**
-	*	@brief Builds a 3D grid.
+	*	@brief Builds a 3D grid, either in the heap or in a memory-mapped file.
 	*/
-	void buildGrid();
+	void buildGrid(bool outOfCore);
 
 	/**
 	*	@brief Cleans the current grid.
@@ -72,11 +132,29 @@ protected:
 	*/
 	size_t countValues(std::unordered_map<uint16_t, unsigned>& values);
 
+	/**
+	*	@brief Gathers the sorted fragment labels to be meshed and fills their metadata. Fragment surfaces are only gathered for active-cell meshing.
+	*	@return Transformation from the padded grid into world space.
+	*/
+	mat4 getMeshingValues(FractureParameters& fractParameters, std::vector<FragmentationProcedure::FragmentMetadata>& fragmentMetadata, std::vector<uint16_t>& values, std::vector<FragmentSurface>& fragments);
+
+	/**
+	*	@brief Gathers the voxel count, bounds and active cells of every fragment within a single sweep. A voxel belongs to the surface if any 
+	*	of its face neighbours has a different label, and every cell where a fragment changes contains one of them.
+	*	@param fragments Fragments sorted by label.
+	*/
+	void getFragmentSurfaces(std::vector<FragmentSurface>& fragments);
+
 	/**
 	*	@brief Retrieves compute shaders from the shader list.
 	*/
 	void getComputeShaders();
 
+	/**
+	*	@return Path of a new temporary file, unique across processes, which backs the given buffer when the grid is out-of-core.
+	*/
+	std::string getMappedFilename(const std::string& buffer) const;
+
 	/**
 	*	@return Index of grid cell to be filled.
 	*/
@@ -85,7 +163,12 @@ protected:
 	/**
 	*	@return Index in grid array of a non-real position.
 	*/
-	unsigned getPositionIndex(int x, int y, int z) const;
+	size_t getPositionIndex(int x, int y, int z) const;
+
+	/**
+	*	@return True if any voxel surrounding the box [min, max) is empty or out of the grid.
+	*/
+	bool isExposed(const uvec3& min, const uvec3& max) const;
 
 	/**
 	*	@brief Resets buffer to a given value.
@@ -101,18 +184,20 @@ public:
 	/**
 	*	@return Index in grid array of a non-real position.
 	*/
-	static unsigned getPositionIndex(int x, int y, int z, const uvec3& numDivs);
+	static size_t getPositionIndex(int x, int y, int z, const uvec3& numDivs);
 
 public:
 	/**
 	*	@brief Constructor which specifies the area and the number of divisions of such area.
+	*	@param outOfCore The grid is backed by a memory-mapped file rather than the heap.
 	*/
-	RegularGrid(const AABB& aabb, const ivec3& subdivisions);
+	RegularGrid(const AABB& aabb, const ivec3& subdivisions, bool outOfCore = false);
 
 	/**
 	*	@brief Constructor of an abstract regular grid with no notion of space size.
+	*	@param outOfCore The grid is backed by a memory-mapped file rather than the heap.
 	*/
-	RegularGrid(const ivec3& subdivisions);
+	RegularGrid(const ivec3& subdivisions, bool outOfCore = false);
 
 	/**
 	*	@brief Invalid copy constructor.
@@ -124,6 +209,11 @@ public:
 	*/
 	virtual ~RegularGrid();
 
+	/**
+	*	@brief Builds a mip pyramid of occupancy from the current voxelization, so that other resolutions of the same bounding box can be instantiated later.
+	*/
+	void buildOccupancyPyramid(OccupancyPyramid& pyramid);
+
 	/**
 	*	@brief Calculates the maximum number of voxels occupied per quadrant.
 	*/
@@ -145,9 +235,14 @@ public:
 	void exportGrid();
 
 	/**
-	*	@brief
+	*	@brief Voxelizes the given mesh. If a cache folder is provided, the occupancy is loaded from (or stored into) the voxelization cache.
+	*/
+	void fill(Model3D::ModelComponent* modelComponent, const FractureParameters& fractParameters);
+
+	/**
+	*	@brief Fills the grid by resampling an occupancy pyramid rather than voxelizing the mesh again. The pyramid is expected to cover the same bounding box.
 	*/
-	void fill(Model3D::ModelComponent* modelComponent);
+	void fill(const OccupancyPyramid& pyramid, FractureParameters::DownsamplingType downsamplingType);
 
 	/**
 	*	@brief
@@ -160,10 +255,27 @@ public:
 	AABB getAABB() { return _aabb; }
 
 	/**
-	*	@brief Retrieves grid AABBs for rendering purposes.
+	*	@return True if the grid is backed by a memory-mapped file.
+	*/
+	bool isOutOfCore() const { return _grid.isMapped(); }
+
+	/**
+	*	@brief Retrieves one AABB per non-empty voxel for rendering purposes. See getMergedAABBs for a much smaller set of boxes covering
+	*	the same voxels.
 	*/
 	void getAABBs(std::vector<AABB>& aabb);
 
+	/**
+	*	@return Size of every cell.
+	*/
+	vec3 getCellSize() const { return _cellSize; }
+
+	/**
+	*	@brief Retrieves grid AABBs by greedily merging voxels with the same value into maximal boxes (along z, then y and then x).
+	*	@param onlySurface Only boxes with at least one face exposed to empty space are retrieved.
+	*/
+	void getMergedAABBs(std::vector<AABB>& aabb, bool onlySurface = false);
+
 	/**
 	*	@brief Inserts a new point in the grid.
 	*/
@@ -175,7 +287,8 @@ public:
 	unsigned numOccupiedVoxels();
 
 	/**
-	*	@brief Queries cluster for each triangle of the given mesh.
+	*	@brief Queries cluster for each triangle of the given mesh. Runs in the GPU unless there is no GL context, the grid is out-of-core 
+	*	or the faces x fragments counters exceed a single buffer, where queryClusterCPU is used instead.
 	*/
 	void queryCluster(const std::vector<Model3D::VertexGPUData>& vertices, const std::vector<Model3D::FaceGPUData>& faces, std::vector<float>& clusterIdx, std::vector<unsigned>& boundaryFaces, std::vector<std::unordered_map<unsigned, float>>& faceClusterOccupancy);
 
@@ -184,6 +297,12 @@ public:
 	*/
 	void queryCluster(std::vector<vec4>* points, std::vector<float>& clusterIdx);
 
+	/**
+	*	@brief Queries cluster for each triangle of the given mesh in the CPU. Each triangle is sampled with a precomputed barycentric pattern,
+	*	so that memory is linear with the number of faces rather than faces x fragments.
+	*/
+	void queryClusterCPU(const std::vector<Model3D::VertexGPUData>& vertices, const std::vector<Model3D::FaceGPUData>& faces, std::vector<float>& clusterIdx, std::vector<unsigned>& boundaryFaces, std::vector<std::unordered_map<unsigned, float>>& faceClusterOccupancy, unsigned numSamples = 1000);
+
 	/**
 	*	@brief Resets regular grid to avoid filling it again.
 	*/
@@ -214,6 +333,13 @@ public:
 	*/
 	std::vector<Model3D*> toTriangleMesh(FractureParameters& fractParameters, std::vector<FragmentationProcedure::FragmentMetadata>& fragmentMetadata);
 
+	/**
+	*	@brief Transforms the regular grid into a triangle mesh per value, which is streamed into the sink returned for its index rather than kept as a model.
+	*	CPU meshers may write several sinks concurrently.
+	*	@return True if every mesh was written.
+	*/
+	bool toTriangleMesh(FractureParameters& fractParameters, std::vector<FragmentationProcedure::FragmentMetadata>& fragmentMetadata, const std::function<MeshSink*(unsigned)>& getSink);
+
 	/**
 	*	@brief Undo the detection of boundaries, thus removing the included mask.
 	*/
@@ -0,0 +1,281 @@
+#include "stdafx.h"
+#include "TriangleBVH.h"
+
+/// [Public methods]
+
+TriangleBVH::TriangleBVH(const std::vector<Model3D::VertexGPUData>& vertices, const std::vector<Model3D::FaceGPUData>& faces)
+{
+	_vertices.resize(vertices.size());
+
+#pragma omp parallel for
+	for (int vertexIdx = 0; vertexIdx < vertices.size(); ++vertexIdx)
+		_vertices[vertexIdx] = vertices[vertexIdx]._position;
+
+	// Morton codes of face centers within the scene bounding box
+	std::vector<vec3> faceCenter(faces.size());
+	vec3 sceneMin = vec3(INFINITY), sceneMax = vec3(-INFINITY);
+
+	for (int faceIdx = 0; faceIdx < faces.size(); ++faceIdx)
+	{
+		const vec3 &a = _vertices[faces[faceIdx]._vertices.x], &b = _vertices[faces[faceIdx]._vertices.y], &c = _vertices[faces[faceIdx]._vertices.z];
+		faceCenter[faceIdx] = (glm::min(a, glm::min(b, c)) + glm::max(a, glm::max(b, c))) / 2.0f;
+
+		sceneMin = glm::min(sceneMin, faceCenter[faceIdx]);
+		sceneMax = glm::max(sceneMax, faceCenter[faceIdx]);
+	}
+
+	const vec3 sceneSize = glm::max(sceneMax - sceneMin, vec3(glm::epsilon<float>()));
+	std::vector<uint32_t> mortonCode(faces.size());
+	std::vector<unsigned> faceOrder(faces.size());
+
+#pragma omp parallel for
+	for (int faceIdx = 0; faceIdx < faces.size(); ++faceIdx)
+	{
+		mortonCode[faceIdx] = TriangleBVH::morton3D((faceCenter[faceIdx] - sceneMin) / sceneSize);
+		faceOrder[faceIdx] = faceIdx;
+	}
+
+	std::sort(faceOrder.begin(), faceOrder.end(), [&](unsigned a, unsigned b) {
+		return mortonCode[a] < mortonCode[b] || (mortonCode[a] == mortonCode[b] && a < b);
+		});
+
+	_faces.resize(faces.size());
+	for (int faceIdx = 0; faceIdx < faces.size(); ++faceIdx)
+		_faces[faceIdx] = faces[faceOrder[faceIdx]]._vertices;
+
+	this->mergeClusters();
+}
+
+float TriangleBVH::windingNumber(const vec3& point) const
+{
+	float windingNumber;
+	this->windingNumbers(&point, 1, &windingNumber);
+
+	return windingNumber;
+}
+
+void TriangleBVH::windingNumbers(const vec3* points, unsigned numPoints, float* windingNumber) const
+{
+	std::fill(windingNumber, windingNumber + numPoints, .0f);
+	if (_nodes.empty() || !numPoints) return;
+
+	// Each stack entry keeps the range of points (in activePoints) which are still close to the node
+	struct Traversal { unsigned _node, _first, _count; };
+
+	std::vector<Traversal> stack;
+	std::vector<unsigned> activePoints(numPoints);
+	std::iota(activePoints.begin(), activePoints.end(), 0);
+	stack.push_back(Traversal{ unsigned(_nodes.size() - 1), 0, numPoints });
+
+	while (!stack.empty())
+	{
+		const Traversal traversal = stack.back();
+		const Node& node = _nodes[traversal._node];
+		stack.pop_back();
+
+		// Points beyond the range of this node belong to subtrees which were already traversed
+		activePoints.resize(traversal._first + traversal._count);
+		const unsigned firstNearPoint = unsigned(activePoints.size());
+
+		// Far nodes are approximated by a dipole
+		for (unsigned activeIdx = traversal._first; activeIdx < traversal._first + traversal._count; ++activeIdx)
+		{
+			const unsigned pointIdx = activePoints[activeIdx];
+			const vec3 direction = node._center - points[pointIdx];
+			const float distance = glm::length(direction);
+
+			if (distance > WINDING_ACCURACY * node._radius)
+				windingNumber[pointIdx] += glm::dot(direction, node._normal) / (4.0f * glm::pi<float>() * distance * distance * distance);
+			else
+				activePoints.push_back(pointIdx);
+		}
+
+		const unsigned numNearPoints = unsigned(activePoints.size()) - firstNearPoint;
+		if (!numNearPoints) continue;
+
+		if (node.isLeaf())
+		{
+			for (unsigned faceIdx = node._firstFace; faceIdx < node._firstFace + node._numFaces; ++faceIdx)
+			{
+				const vec3 &a = _vertices[_faces[faceIdx].x], &b = _vertices[_faces[faceIdx].y], &c = _vertices[_faces[faceIdx].z];
+
+				for (unsigned activeIdx = firstNearPoint; activeIdx < firstNearPoint + numNearPoints; ++activeIdx)
+				{
+					const vec3& point = points[activePoints[activeIdx]];
+					windingNumber[activePoints[activeIdx]] += TriangleBVH::solidAngle(a - point, b - point, c - point);
+				}
+			}
+		}
+		else
+		{
+			stack.push_back(Traversal{ node._left, firstNearPoint, numNearPoints });
+			stack.push_back(Traversal{ node._right, firstNearPoint, numNearPoints });
+		}
+	}
+}
+
+/// [Protected methods]
+
+uint32_t TriangleBVH::expandBits(uint32_t value)
+{
+	value = (value * 0x00010001u) & 0xFF0000FFu;
+	value = (value * 0x00000101u) & 0x0F00F00Fu;
+	value = (value * 0x00000011u) & 0xC30C30C3u;
+	value = (value * 0x00000005u) & 0x49249249u;
+
+	return value;
+}
+
+void TriangleBVH::fillWindingData(Node& node) const
+{
+	if (node.isLeaf())
+	{
+		node._area = .0f;
+		node._center = node._normal = vec3(.0f);
+
+		for (unsigned faceIdx = node._firstFace; faceIdx < node._firstFace + node._numFaces; ++faceIdx)
+		{
+			const vec3 &a = _vertices[_faces[faceIdx].x], &b = _vertices[_faces[faceIdx].y], &c = _vertices[_faces[faceIdx].z];
+			const vec3 normal = glm::cross(b - a, c - a) / 2.0f;
+			const float area = glm::length(normal);
+
+			node._normal += normal;
+			node._center += area * (a + b + c) / 3.0f;
+			node._area += area;
+		}
+
+		node._center = node._area > .0f ? node._center / node._area : (node._min + node._max) / 2.0f;
+		node._radius = .0f;
+
+		for (unsigned faceIdx = node._firstFace; faceIdx < node._firstFace + node._numFaces; ++faceIdx)
+		{
+			for (int vertexIdx = 0; vertexIdx < 3; ++vertexIdx)
+				node._radius = glm::max(node._radius, glm::distance(node._center, _vertices[_faces[faceIdx][vertexIdx]]));
+		}
+	}
+	else
+	{
+		const Node &left = _nodes[node._left], &right = _nodes[node._right];
+
+		node._area = left._area + right._area;
+		node._normal = left._normal + right._normal;
+		node._center = node._area > .0f ? (left._area * left._center + right._area * right._center) / node._area : (node._min + node._max) / 2.0f;
+		node._radius = glm::max(glm::distance(node._center, left._center) + left._radius, glm::distance(node._center, right._center) + right._radius);
+	}
+
+	// Faces are also enclosed by the bounding box, whose farthest corner may be closer
+	node._radius = glm::min(node._radius, glm::length(glm::max(node._center - node._min, node._max - node._center)));
+}
+
+void TriangleBVH::mergeClusters()
+{
+	std::vector<unsigned> clusters, mergedClusters;
+	std::vector<int> neighbour;
+
+	// Leaves of consecutive faces in Morton order
+	for (unsigned firstFace = 0; firstFace < _faces.size(); firstFace += LEAF_SIZE)
+	{
+		Node leaf;
+		leaf._firstFace = firstFace;
+		leaf._numFaces = std::min(LEAF_SIZE, unsigned(_faces.size()) - firstFace);
+		leaf._left = leaf._right = 0;
+		leaf._min = vec3(INFINITY);
+		leaf._max = vec3(-INFINITY);
+
+		for (unsigned faceIdx = firstFace; faceIdx < firstFace + leaf._numFaces; ++faceIdx)
+		{
+			for (int vertexIdx = 0; vertexIdx < 3; ++vertexIdx)
+			{
+				leaf._min = glm::min(leaf._min, _vertices[_faces[faceIdx][vertexIdx]]);
+				leaf._max = glm::max(leaf._max, _vertices[_faces[faceIdx][vertexIdx]]);
+			}
+		}
+
+		this->fillWindingData(leaf);
+
+		clusters.push_back(unsigned(_nodes.size()));
+		_nodes.push_back(leaf);
+	}
+
+	while (clusters.size() > 1)
+	{
+		const int numClusters = int(clusters.size());
+		neighbour.resize(numClusters);
+
+#pragma omp parallel for
+		for (int clusterIdx = 0; clusterIdx < numClusters; ++clusterIdx)
+		{
+			const int lowerIdx = std::max(clusterIdx - int(SEARCH_RADIUS), 0), upperIdx = std::min(clusterIdx + int(SEARCH_RADIUS), numClusters - 1);
+			float minArea = std::numeric_limits<float>::infinity();
+			neighbour[clusterIdx] = clusterIdx;
+
+			for (int candidateIdx = lowerIdx; candidateIdx <= upperIdx; ++candidateIdx)
+			{
+				if (candidateIdx == clusterIdx) continue;
+
+				// NaN areas are worse than any finite one, but a neighbour is always chosen so that every pass merges some pair
+				float area = TriangleBVH::surfaceArea(_nodes[clusters[clusterIdx]], _nodes[clusters[candidateIdx]]);
+				if (std::isnan(area)) area = std::numeric_limits<float>::infinity();
+
+				if (area < minArea || neighbour[clusterIdx] == clusterIdx)
+				{
+					minArea = area;
+					neighbour[clusterIdx] = candidateIdx;
+				}
+			}
+		}
+
+		// Mutual nearest neighbours are merged, and the new cluster takes the place of the first one
+		mergedClusters.clear();
+
+		for (int clusterIdx = 0; clusterIdx < numClusters; ++clusterIdx)
+		{
+			const int neighbourIdx = neighbour[clusterIdx];
+
+			if (neighbourIdx == clusterIdx || neighbour[neighbourIdx] != clusterIdx)
+			{
+				mergedClusters.push_back(clusters[clusterIdx]);
+			}
+			else if (clusterIdx < neighbourIdx)
+			{
+				Node node;
+				node._left = clusters[clusterIdx];
+				node._right = clusters[neighbourIdx];
+				node._firstFace = node._numFaces = 0;
+				node._min = glm::min(_nodes[node._left]._min, _nodes[node._right]._min);
+				node._max = glm::max(_nodes[node._left]._max, _nodes[node._right]._max);
+
+				this->fillWindingData(node);
+
+				mergedClusters.push_back(unsigned(_nodes.size()));
+				_nodes.push_back(node);
+			}
+		}
+
+		clusters.swap(mergedClusters);
+	}
+}
+
+uint32_t TriangleBVH::morton3D(const vec3& position)
+{
+	const uvec3 cell = uvec3(glm::clamp(position * 1024.0f, vec3(.0f), vec3(1023.0f)));
+
+	return TriangleBVH::expandBits(cell.x) * 4 + TriangleBVH::expandBits(cell.y) * 2 + TriangleBVH::expandBits(cell.z);
+}
+
+float TriangleBVH::solidAngle(const vec3& a, const vec3& b, const vec3& c)
+{
+	const float lengthA = glm::length(a), lengthB = glm::length(b), lengthC = glm::length(c);
+	const float determinant = glm::dot(a, glm::cross(b, c));
+	const float denominator = lengthA * lengthB * lengthC + glm::dot(a, b) * lengthC + glm::dot(a, c) * lengthB + glm::dot(b, c) * lengthA;
+
+	// Van Oosterom and Strackee formula: tan(omega / 2) = det / denominator
+	return std::atan2(determinant, denominator) / (2.0f * glm::pi<float>());
+}
+
+float TriangleBVH::surfaceArea(const Node& node1, const Node& node2)
+{
+	const vec3 length = glm::max(node1._max, node2._max) - glm::min(node1._min, node2._min);
+
+	return 2.0f * (length.x * length.y + length.z * length.y + length.x * length.z);
+}
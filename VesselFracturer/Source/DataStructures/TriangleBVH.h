@@ -0,0 +1,100 @@
+#pragma once
+
+#include "Graphics/Core/Model3D.h"
+
+/**
+*	@file TriangleBVH.h
+*	@authors Alfonso Lpez Ruiz (alr00048@red.ujaen.es)
+*	@date 19/10/2026
+*/
+
+/**
+*	@brief CPU bounding volume hierarchy over the triangles of a mesh, built as the BVHGeneration shaders do: faces are sorted by Morton codes 
+*	and clusters are merged with their best neighbour (smallest merged surface area) within a search radius. Nodes also keep the dipole 
+*	data needed to evaluate the fast winding number (Barill et al., 2018).
+*/
+class TriangleBVH
+{
+protected:
+	const unsigned	LEAF_SIZE = 4;						//!< Maximum number of consecutive (Morton order) faces of a leaf
+	const unsigned	SEARCH_RADIUS = 16;					//!< Neighbourhood searched for the best cluster to merge with
+	const float		WINDING_ACCURACY = 1.0f;			//!< A node is approximated when its distance to the query is greater than accuracy * radius. Enough to classify at 0.5
+
+	/**
+	*	@brief Node of the hierarchy. Leaves have faces, whereas inner nodes have two children.
+	*/
+	struct Node
+	{
+		vec3		_min, _max;							//!< Bounding box
+		vec3		_center;							//!< Area-weighted centroid of the faces
+		float		_radius;							//!< Radius of the sphere centered at _center which encloses the faces
+		vec3		_normal;							//!< Sum of area-weighted normals of the faces (dipole strength)
+		float		_area;								//!< Total area of the faces
+		unsigned	_left, _right;						//!< Children
+		unsigned	_firstFace, _numFaces;				//!< Faces of leaves in _faces
+
+		/**
+		*	@return True if the node has no children.
+		*/
+		bool isLeaf() const { return _numFaces > 0; }
+	};
+
+protected:
+	std::vector<uvec3>	_faces;							//!< Vertex indices of faces, sorted by Morton code
+	std::vector<Node>	_nodes;							//!< Nodes of the hierarchy, each one is placed after its children
+	std::vector<vec3>	_vertices;						//!< Vertex positions
+
+protected:
+	/**
+	*	@brief Expands a 10-bit integer into 30 bits by inserting 2 zeros after each bit.
+	*/
+	static uint32_t expandBits(uint32_t value);
+
+	/**
+	*	@brief Computes the winding number data of a node from its faces or children.
+	*/
+	void fillWindingData(Node& node) const;
+
+	/**
+	*	@brief Builds the hierarchy by merging nearest clusters, starting from leaves of Morton-sorted faces.
+	*/
+	void mergeClusters();
+
+	/**
+	*	@return Calculates a 30-bit Morton code for the given point located within the unit cube [0, 1].
+	*/
+	static uint32_t morton3D(const vec3& position);
+
+	/**
+	*	@return Solid angle of a triangle as seen from the origin, divided by 4 pi.
+	*/
+	static float solidAngle(const vec3& a, const vec3& b, const vec3& c);
+
+	/**
+	*	@return Surface area of the box which encloses both nodes.
+	*/
+	static float surfaceArea(const Node& node1, const Node& node2);
+
+public:
+	/**
+	*	@brief Constructor.
+	*/
+	TriangleBVH(const std::vector<Model3D::VertexGPUData>& vertices, const std::vector<Model3D::FaceGPUData>& faces);
+
+	/**
+	*	@return Number of nodes.
+	*/
+	size_t getNumNodes() const { return _nodes.size(); }
+
+	/**
+	*	@return Winding number of the mesh at the given point, i.e. close to 1 inside and close to 0 outside, even for open meshes.
+	*/
+	float windingNumber(const vec3& point) const;
+
+	/**
+	*	@brief Evaluates the winding number of a batch of nearby points with a single traversal of the hierarchy. Each node keeps track of 
+	*	the points which are still close to it, so that results are the same as evaluating every point separately.
+	*/
+	void windingNumbers(const vec3* points, unsigned numPoints, float* windingNumber) const;
+};
+
@@ -0,0 +1,135 @@
+#include "stdafx.h"
+#include "VoxelizationCache.h"
+
+#include "Utilities/FileManagement.h"
+#include "Utilities/HashUtilities.h"
+#include "Utilities/MappedFile.h"
+#include <iomanip>
+
+/// [Public methods]
+
+VoxelizationCache::VoxelizationCache(const std::string& folder, const Model3D::ModelComponent* modelComponent, const AABB& aabb, const uvec3& numDivs, uint32_t voxelizationType) :
+	_aabb(aabb), _folder(folder), _meshHash(0), _numDivs(numDivs), _voxelizationType(voxelizationType)
+{
+	uint64_t meshHash = HashUtilities::FNV_OFFSET_BASIS;
+
+	for (const Model3D::VertexGPUData& vertex : modelComponent->_geometry)
+		meshHash = HashUtilities::fnv1a(&vertex._position, sizeof(vec3), meshHash);
+
+	for (const Model3D::FaceGPUData& face : modelComponent->_topology)
+		meshHash = HashUtilities::fnv1a(&face._vertices, sizeof(uvec3), meshHash);
+
+	_meshHash = meshHash;
+}
+
+std::string VoxelizationCache::getFilename() const
+{
+	const vec3 min = _aabb.min(), max = _aabb.max();
+
+	uint64_t key = HashUtilities::fnv1a(&min, sizeof(vec3), _meshHash);
+	key = HashUtilities::fnv1a(&max, sizeof(vec3), key);
+	key = HashUtilities::fnv1a(&_numDivs, sizeof(uvec3), key);
+	key = HashUtilities::fnv1a(&_voxelizationType, sizeof(uint32_t), key);
+
+	std::stringstream filename;
+	filename << std::hex << std::setw(16) << std::setfill('0') << key << ".vxc";
+
+	return (std::filesystem::path(_folder) / filename.str()).string();
+}
+
+bool VoxelizationCache::load(RegularGrid::CellGrid* grid) const
+{
+	MappedFile mappedFile;
+	if (!mappedFile.open(this->getFilename(), MappedFile::READ_ONLY) || mappedFile.size() < sizeof(Header)) return false;
+
+	const Header* header = static_cast<const Header*>(mappedFile.data());
+	const uint32_t* runs = reinterpret_cast<const uint32_t*>(header + 1);
+	const size_t numCells = size_t(_numDivs.x) * _numDivs.y * _numDivs.z;
+
+	if (!this->matches(*header) || mappedFile.size() != sizeof(Header) + header->_numRuns * sizeof(uint32_t)) return false;
+
+	size_t numDecoded = 0;
+	for (uint64_t runIdx = 0; runIdx < header->_numRuns; ++runIdx)
+		numDecoded += runs[runIdx];
+
+	if (numDecoded != numCells) return false;
+
+	mappedFile.prefetch(0, mappedFile.size());
+
+	size_t cellIdx = 0;
+	for (uint64_t runIdx = 0; runIdx < header->_numRuns; ++runIdx)
+	{
+		if (runIdx % 2) std::fill(grid + cellIdx, grid + cellIdx + runs[runIdx], RegularGrid::CellGrid(VOXEL_FREE));
+		cellIdx += runs[runIdx];
+	}
+
+	return true;
+}
+
+bool VoxelizationCache::save(const RegularGrid::CellGrid* grid) const
+{
+	const size_t numCells = size_t(_numDivs.x) * _numDivs.y * _numDivs.z;
+	std::vector<uint32_t> runs(1, 0);
+
+	bool occupied = false;
+	for (size_t cellIdx = 0; cellIdx < numCells; ++cellIdx)
+	{
+		const bool cellOccupied = grid[cellIdx]._value != VOXEL_EMPTY;
+
+		if (cellOccupied != occupied)
+		{
+			occupied = cellOccupied;
+			runs.push_back(0);
+		}
+		else if (runs.back() == UINT32_MAX)
+		{
+			runs.push_back(0);														// Zero-length run to keep the alternation
+			runs.push_back(0);
+		}
+
+		++runs.back();
+	}
+
+	std::error_code errorCode;
+	std::filesystem::create_directories(_folder, errorCode);
+
+	// Written into a temporary file first, so that concurrent runs never map an incomplete entry
+	const std::string filename = this->getFilename(), temporaryFilename = filename + ".tmp" + FileManagement::getUniqueSuffix();
+	std::ofstream outputStream(temporaryFilename, std::ios::out | std::ios::binary);
+	if (outputStream.fail()) return false;
+
+	Header header;
+	std::copy(MAGIC, MAGIC + 4, header._magic);
+	header._version = VERSION;
+	header._meshHash = _meshHash;
+	header._min = _aabb.min();
+	header._max = _aabb.max();
+	header._numDivs = _numDivs;
+	header._voxelizationType = _voxelizationType;
+	header._numRuns = runs.size();
+
+	outputStream.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+	outputStream.write(reinterpret_cast<const char*>(runs.data()), runs.size() * sizeof(uint32_t));
+	outputStream.close();
+
+	if (outputStream.fail())
+	{
+		std::filesystem::remove(temporaryFilename, errorCode);
+		return false;
+	}
+
+	std::filesystem::rename(temporaryFilename, filename, errorCode);
+	if (!errorCode) return true;
+
+	std::filesystem::remove(temporaryFilename, errorCode);
+
+	return false;
+}
+
+/// [Protected methods]
+
+bool VoxelizationCache::matches(const Header& header) const
+{
+	return std::equal(MAGIC, MAGIC + 4, header._magic) && header._version == VERSION && header._meshHash == _meshHash &&
+		header._min == _aabb.min() && header._max == _aabb.max() && header._numDivs == _numDivs && header._voxelizationType == _voxelizationType;
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "DataStructures/RegularGrid.h"
+#include "Geometry/3D/AABB.h"
+
+/**
+*	@file VoxelizationCache.h
+*	@authors Alfonso Lpez Ruiz (alr00048@red.ujaen.es)
+*	@date 19/10/2026
+*/
+
+/**
+*	@brief On-disk cache of voxelized meshes. Occupancy is stored as run-length encoded spans in grid order, and it is 
+*	identified by a content hash of the mesh, its bounding box and the grid dimensions.
+*/
+class VoxelizationCache
+{
+protected:
+	inline static const char		MAGIC[4] = { 'V', 'X', 'C', 'H' };
+	inline static const uint32_t	VERSION = 1;
+
+	/**
+	*	@brief Header of a cache file, followed by _numRuns run lengths, alternating empty and occupied spans (starting by an empty one).
+	*/
+	struct Header
+	{
+		char		_magic[4];
+		uint32_t	_version;
+		uint64_t	_meshHash;
+		vec3		_min, _max;
+		uvec3		_numDivs;
+		uint32_t	_voxelizationType;
+		uint64_t	_numRuns;
+	};
+
+protected:
+	AABB			_aabb;								//!< Bounding box of the voxelization
+	std::string		_folder;							//!< Folder where cache files are stored
+	uint64_t		_meshHash;							//!< Content hash of vertices and faces
+	uvec3			_numDivs;							//!< Grid dimensions
+	uint32_t		_voxelizationType;					//!< Algorithm which computed the occupancy
+
+protected:
+	/**
+	*	@return True if the header belongs to the mesh, bounding box and grid dimensions of this cache entry.
+	*/
+	bool matches(const Header& header) const;
+
+public:
+	/**
+	*	@brief Constructor. The mesh hash is computed from vertex positions and face indices.
+	*/
+	VoxelizationCache(const std::string& folder, const Model3D::ModelComponent* modelComponent, const AABB& aabb, const uvec3& numDivs, uint32_t voxelizationType);
+
+	/**
+	*	@return Path of the cache file for this mesh, bounding box, grid dimensions and voxelization algorithm.
+	*/
+	std::string getFilename() const;
+
+	/**
+	*	@brief Decodes the cached occupancy from the mapped file straight into the grid, which is expected to be clean. 
+	*	@return False if there is no valid entry.
+	*/
+	bool load(RegularGrid::CellGrid* grid) const;
+
+	/**
+	*	@brief Stores the occupancy (non-empty voxels) of the given grid.
+	*/
+	bool save(const RegularGrid::CellGrid* grid) const;
+};
+
@@ -105,7 +105,7 @@ namespace fracturer {
 
 		// Load seeds as a subset
 		std::vector<GLuint> seedsInt;
-		for (auto& seed : seeds) seedsInt.push_back(RegularGrid::getPositionIndex(seed.x, seed.y, seed.z, numDivs));
+		for (auto& seed : seeds) seedsInt.push_back(static_cast<GLuint>(RegularGrid::getPositionIndex(seed.x, seed.y, seed.z, numDivs)));
 
 		ComputeShader::updateReadBufferSubset(_stack1SSBO, seedsInt.data(), 0, seeds.size());
 
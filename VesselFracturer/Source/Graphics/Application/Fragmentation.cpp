@@ -1,6 +1,7 @@
 #include "stdafx.h"
 #include "Fragmentation.h"
 
+#include "DataStructures/OccupancyPyramid.h"
 #include "Geometry/3D/PointCloud3D.h"
 #include "Graphics/Core/AssimpModel.h"
 #include "Graphics/Core/FractureParameters.h"
@@ -8,6 +9,9 @@
 #include "progressbar.hpp"
 #include "Utilities/ChronoUtilities.h"
 #include "Utilities/FileManagement.h"
+#include "Utilities/MemoryUtilities.h"
+#include "Utilities/WriterPool.h"
+#include "Utilities/ZipArchive.h"
 
 
 /// Initialization of static attributes
@@ -51,7 +55,7 @@ std::string Fragmentation::fractureGrid(const std::string& path, std::vector<Fra
 	if (!_generateDataset)
 	{
 		if (!_meshGrid)
-			_meshGrid = new RegularGrid(ivec3(_fractParameters._clampVoxelMetricUnit));
+			_meshGrid = new RegularGrid(ivec3(_fractParameters._clampVoxelMetricUnit), _fractParameters._outOfCoreGrid);
 
 		this->allocateMeshGrid(_fractParameters);
 	}
@@ -86,95 +90,133 @@ void Fragmentation::generateDataset(FragmentationProcedure& fractureProcedure, c
 		std::vector<FragmentationProcedure::FragmentMetadata> modelMetadata;
 		this->loadModel(path);
 
+		// Writes of the previous model have been flushed, so the statistics printed below belong to this model only
+		WriterPool::getInstance()->resetStatistics();
+
 		const std::string modelName = _mesh->getShortName();
 		const std::string meshFolder = fractureProcedure._currentDestinationFolder + modelName + "/";
 		const std::string meshFile = meshFolder + modelName + "_";
 		if (!std::filesystem::exists(meshFolder)) std::filesystem::create_directory(meshFolder);
 
-		// Calculate size of voxelization according to model size
-		const AABB aabb = _mesh->getAABB();
-		fractureProcedure._fractureParameters._gridSubdivisions = glm::ceil(aabb.size() * vec3(fractureProcedure._fractureParameters._voxelPerMetricUnit));
-		if (fractureProcedure._fractureParameters._gridSubdivisions.x > fractureProcedure._fractureParameters._clampVoxelMetricUnit or
-			fractureProcedure._fractureParameters._gridSubdivisions.y > fractureProcedure._fractureParameters._clampVoxelMetricUnit or
-			fractureProcedure._fractureParameters._gridSubdivisions.z > fractureProcedure._fractureParameters._clampVoxelMetricUnit)
-		{
-			fractureProcedure._fractureParameters._gridSubdivisions =
-				glm::floor(vec3(fractureProcedure._fractureParameters._clampVoxelMetricUnit) *
-					aabb.size() / glm::max(aabb.size().x, glm::max(aabb.size().y, aabb.size().z)));
-			std::cout << modelName << " - " << "Voxelization size clamped to " << fractureProcedure._fractureParameters._clampVoxelMetricUnit << std::endl;
-		}
-		while (fractureProcedure._fractureParameters._gridSubdivisions.x % 4 != 0) ++fractureProcedure._fractureParameters._gridSubdivisions.x;
-		while (fractureProcedure._fractureParameters._gridSubdivisions.z % 4 != 0) ++fractureProcedure._fractureParameters._gridSubdivisions.z;
+		// Fragments are compressed into an archive beside the folder as soon as they are produced
+		ZipArchive archive;
+		if (fractureProcedure._compressFiles && !archive.open(meshFolder.substr(0, meshFolder.size() - 1) + ".zip"))
+			std::cout << modelName << " - " << "Archive could not be created, fragments are saved uncompressed" << std::endl;
 
-		std::cout << modelName << " - " << fractureProcedure._fractureParameters._gridSubdivisions.x << "x" << fractureProcedure._fractureParameters._gridSubdivisions.y << "x" << fractureProcedure._fractureParameters._gridSubdivisions.z << std::endl;
+		// Every resolution is instantiated from a single voxelization, the finest one, through an occupancy pyramid
+		std::vector<int> resolutions = fractureProcedure._voxelPerMetricUnits;
+		if (resolutions.empty()) resolutions.push_back(fractureProcedure._fractureParameters._voxelPerMetricUnit);
+		std::sort(resolutions.begin(), resolutions.end(), std::greater<int>());
+		resolutions.erase(std::unique(resolutions.begin(), resolutions.end()), resolutions.end());
 
-		// Initialize grid content
-		_meshGrid->setAABB(_mesh->getAABB(), fractureProcedure._fractureParameters._gridSubdivisions);
-		_meshGrid->fill(_mesh->getModelComponent(0));
-		_meshGrid->resetMarchingCubes();
-		_mesh->getModelComponent(0)->releaseMemory();
+		const AABB aabb = _mesh->getAABB();
+		OccupancyPyramid pyramid;
 
-		for (int numFragments = fractureProcedure._fragmentInterval.x; numFragments <= fractureProcedure._fragmentInterval.y; ++numFragments)
+		for (int resolutionIdx = 0; resolutionIdx < resolutions.size(); ++resolutionIdx)
 		{
-			const std::string fragmentFile = meshFile + std::to_string(numFragments) + "f_";
+			const std::string resolutionFile = resolutions.size() > 1 ? meshFile + std::to_string(resolutions[resolutionIdx]) + "vpu_" : meshFile;
+
+			// Calculate size of voxelization according to model size
+			fractureProcedure._fractureParameters._voxelPerMetricUnit = resolutions[resolutionIdx];
+			fractureProcedure._fractureParameters._gridSubdivisions = glm::ceil(aabb.size() * vec3(fractureProcedure._fractureParameters._voxelPerMetricUnit));
+			if (fractureProcedure._fractureParameters._gridSubdivisions.x > fractureProcedure._fractureParameters._clampVoxelMetricUnit or
+				fractureProcedure._fractureParameters._gridSubdivisions.y > fractureProcedure._fractureParameters._clampVoxelMetricUnit or
+				fractureProcedure._fractureParameters._gridSubdivisions.z > fractureProcedure._fractureParameters._clampVoxelMetricUnit)
+			{
+				fractureProcedure._fractureParameters._gridSubdivisions =
+					glm::floor(vec3(fractureProcedure._fractureParameters._clampVoxelMetricUnit) *
+						aabb.size() / glm::max(aabb.size().x, glm::max(aabb.size().y, aabb.size().z)));
+				std::cout << modelName << " - " << "Voxelization size clamped to " << fractureProcedure._fractureParameters._clampVoxelMetricUnit << std::endl;
+			}
+			while (fractureProcedure._fractureParameters._gridSubdivisions.x % 4 != 0) ++fractureProcedure._fractureParameters._gridSubdivisions.x;
+			while (fractureProcedure._fractureParameters._gridSubdivisions.z % 4 != 0) ++fractureProcedure._fractureParameters._gridSubdivisions.z;
 
-			fractureProcedure._fractureParameters._numExtraSeeds = 2;
-			fractureProcedure._fractureParameters._numSeeds = numFragments;
-			const int numIterations = glm::mix(
-				fractureProcedure._iterationInterval.x, fractureProcedure._iterationInterval.y,
-				static_cast<float>(numFragments - fractureProcedure._fragmentInterval.x) / (fractureProcedure._fragmentInterval.y - fractureProcedure._fragmentInterval.x));
+			std::cout << modelName << " - " << fractureProcedure._fractureParameters._gridSubdivisions.x << "x" << fractureProcedure._fractureParameters._gridSubdivisions.y << "x" << fractureProcedure._fractureParameters._gridSubdivisions.z << std::endl;
 
-			std::cout << modelName << " - " << numFragments << " fragments ";
-			progressbar bar(numIterations);
+			// Initialize grid content
+			_meshGrid->setAABB(aabb, fractureProcedure._fractureParameters._gridSubdivisions);
+			if (resolutionIdx == 0)
+			{
+				_meshGrid->fill(_mesh->getModelComponent(0), fractureProcedure._fractureParameters);
+				_mesh->getModelComponent(0)->releaseMemory();
 
-			for (int iteration = 0; iteration < numIterations; ++iteration)
+				if (resolutions.size() > 1) _meshGrid->buildOccupancyPyramid(pyramid);
+			}
+			else
 			{
-				bar.update();
+				_meshGrid->fill(pyramid, static_cast<FractureParameters::DownsamplingType>(fractureProcedure._fractureParameters._downsamplingType));
+			}
+			_meshGrid->resetMarchingCubes();
 
-				unsigned idx = 0;
-				const std::string itFile = fragmentFile + std::to_string(iteration) + "it";
-				std::vector<FragmentationProcedure::FragmentMetadata> localMetadata;
+			std::cout << modelName << " - " << "Resident set size: " << MemoryUtilities::getResidentSetSize() << " MB" << (_meshGrid->isOutOfCore() ? " (out-of-core grid)" : "") << std::endl;
 
-				this->fractureGrid(fragmentMetadata, fractureProcedure._fractureParameters);
+			for (int numFragments = fractureProcedure._fragmentInterval.x; numFragments <= fractureProcedure._fragmentInterval.y; ++numFragments)
+			{
+				const std::string fragmentFile = resolutionFile + std::to_string(numFragments) + "f_";
 
-				for (Model3D* fracture : _fractureMeshes)
+				fractureProcedure._fractureParameters._numExtraSeeds = 2;
+				fractureProcedure._fractureParameters._numSeeds = numFragments;
+				const int numIterations = glm::mix(
+					fractureProcedure._iterationInterval.x, fractureProcedure._iterationInterval.y,
+					static_cast<float>(numFragments - fractureProcedure._fragmentInterval.x) / (fractureProcedure._fragmentInterval.y - fractureProcedure._fragmentInterval.x));
+
+				std::cout << modelName << " - " << numFragments << " fragments ";
+				progressbar bar(numIterations);
+
+				for (int iteration = 0; iteration < numIterations; ++iteration)
 				{
-					AssimpModel* cadModel = dynamic_cast<AssimpModel*>(fracture);
-					const std::string filename = itFile + "_" + std::to_string(idx);
-					std::string simplificationFilename;
+					bar.update();
+
+					unsigned idx = 0;
+					const std::string itFile = fragmentFile + std::to_string(iteration) + "it";
+					std::vector<FragmentationProcedure::FragmentMetadata> localMetadata;
+
+					this->fractureGrid(fragmentMetadata, fractureProcedure._fractureParameters);
+
+					const std::vector<int>& targetTriangles = fractureProcedure._fractureParameters._targetTriangles;
 
-					if (!fractureProcedure._fractureParameters._targetTriangles.empty())
+					if (!targetTriangles.empty())
 					{
-						for (int targetCount : fractureProcedure._fractureParameters._targetTriangles)
-						{
-							simplificationFilename = filename + "_" + std::to_string(targetCount) + fractureProcedure._saveExtension;
-							cadModel->simplify(targetCount);
-							cadModel->save(simplificationFilename, fractureProcedure._compressFiles);
+						// Every target is reached from the previous one, so fragments are decimated concurrently and then saved in order
+						localMetadata.resize(_fractureMeshes.size() * targetTriangles.size());
 
-							fragmentMetadata[idx]._vesselName = simplificationFilename;
-							fragmentMetadata[idx]._numVertices = fracture->getNumVertices();
-							fragmentMetadata[idx]._numFaces = fracture->getNumFaces();
-							localMetadata.push_back(fragmentMetadata[idx]);
+						for (int targetIdx = 0; targetIdx < targetTriangles.size(); ++targetIdx)
+						{
+#pragma omp parallel for schedule(dynamic)
+							for (int fractureIdx = 0; fractureIdx < _fractureMeshes.size(); ++fractureIdx)
+								dynamic_cast<AssimpModel*>(_fractureMeshes[fractureIdx])->simplify(targetTriangles[targetIdx]);
+
+							for (idx = 0; idx < _fractureMeshes.size(); ++idx)
+							{
+								Model3D* fracture = _fractureMeshes[idx];
+								const std::string simplificationFilename = itFile + "_" + std::to_string(idx) + "_" + std::to_string(targetTriangles[targetIdx]) + fractureProcedure._saveExtension;
+								fragmentMetadata[idx]._vesselName = this->saveFragment(dynamic_cast<AssimpModel*>(fracture), simplificationFilename, archive, fractureProcedure._compressFiles);
+								fragmentMetadata[idx]._numVertices = fracture->getNumVertices();
+								fragmentMetadata[idx]._numFaces = fracture->getNumFaces();
+								localMetadata[idx * targetTriangles.size() + targetIdx] = fragmentMetadata[idx];
+							}
 						}
 					}
 					else
 					{
-						cadModel->save(filename + fractureProcedure._saveExtension, fractureProcedure._compressFiles);
+						for (Model3D* fracture : _fractureMeshes)
+						{
+							const std::string filename = itFile + "_" + std::to_string(idx) + fractureProcedure._saveExtension;
+							fragmentMetadata[idx]._vesselName = this->saveFragment(dynamic_cast<AssimpModel*>(fracture), filename, archive, fractureProcedure._compressFiles);
+							fragmentMetadata[idx]._numVertices = fracture->getNumVertices();
+							fragmentMetadata[idx]._numFaces = fracture->getNumFaces();
+							localMetadata.push_back(fragmentMetadata[idx]);
 
-						fragmentMetadata[idx]._vesselName = filename + fractureProcedure._saveExtension;
-						fragmentMetadata[idx]._numVertices = fracture->getNumVertices();
-						fragmentMetadata[idx]._numFaces = fracture->getNumFaces();
-						localMetadata.push_back(fragmentMetadata[idx]);
+							++idx;
+						}
 					}
 
-					++idx;
+					modelMetadata.insert(modelMetadata.end(), localMetadata.begin(), localMetadata.end());
+					fragmentMetadata.clear();
 				}
 
-				modelMetadata.insert(modelMetadata.end(), localMetadata.begin(), localMetadata.end());
-				fragmentMetadata.clear();
+				std::cout << std::endl;
 			}
-
-			std::cout << std::endl;
 		}
 
 		if (fractureProcedure._exportMetadata)
@@ -182,11 +224,14 @@ void Fragmentation::generateDataset(FragmentationProcedure& fractureProcedure, c
 			this->exportMetadata(meshFile + "metadata.txt", modelMetadata);
 		}
 
-		if (fractureProcedure._compressFiles)
-		{
-			std::thread compressFolder(&Fragmentation::launchZipingProcess, this, meshFolder);
-			compressFolder.detach();
-		}
+		if (archive.isOpen() && !archive.close())
+			std::cout << modelName << " - " << "Archive " << archive.getFilename() << " could not be completed" << std::endl;
+
+		WriterPool* writerPool = WriterPool::getInstance();
+		writerPool->flush();
+
+		std::cout << modelName << " - " << "Written " << writerPool->getBytesWritten() / (1024 * 1024) << " MB, peak write queue depth: " << writerPool->getMaxQueueDepth()
+			<< (writerPool->getNumFailedJobs() ? ", failed writes: " + std::to_string(writerPool->getNumFailedJobs()) : "") << std::endl;
 	}
 }
 
@@ -195,7 +240,7 @@ void Fragmentation::generateDataset(FragmentationProcedure& fractureProcedure, c
 void Fragmentation::allocateMemoryDataset(FragmentationProcedure& fractureProcedure)
 {
 	// Prepare regular grid
-	_meshGrid = new RegularGrid(ivec3(fractureProcedure._fractureParameters._clampVoxelMetricUnit));
+	_meshGrid = new RegularGrid(ivec3(fractureProcedure._fractureParameters._clampVoxelMetricUnit), fractureProcedure._fractureParameters._outOfCoreGrid);
 
 	// Prepare GPU memory for fracturing
 	fracturer::Fracturer* fracturer = fracturer::FloodFracturer::getInstance();
@@ -214,7 +259,7 @@ void Fragmentation::allocateMeshGrid(FractureParameters& fractParameters)
 	while (fractParameters._gridSubdivisions.z % 4 != 0) ++fractParameters._gridSubdivisions.z;
 
 	_meshGrid->setAABB(aabb, fractParameters._gridSubdivisions);
-	_meshGrid->fill(_mesh->getModelComponent(0));
+	_meshGrid->fill(_mesh->getModelComponent(0), fractParameters);
 	_meshGrid->resetMarchingCubes();
 }
 
@@ -293,17 +338,6 @@ std::string Fragmentation::fractureModel(FractureParameters& fractParameters)
 	return "";
 }
 
-void Fragmentation::launchZipingProcess(const std::string& folder)
-{
-	//std::filesystem::copy(folder, destinationFolder, std::filesystem::copy_options::recursive | std::filesystem::copy_options::overwrite_existing);
-	const std::string currentPath = std::filesystem::current_path().string();
-	const std::string systemUnit = currentPath.substr(0, currentPath.find_first_of("/\\"));
-	const std::string cd = "cd " + currentPath;
-	const std::string command = cd + " && " + systemUnit + " && " + "Bash\\zip.bat " + folder + " " + folder.substr(0, folder.find_first_of("/\\")) + " >nul";
-
-	std::system(command.c_str());
-}
-
 void Fragmentation::loadModels()
 {
 	_fragmentMetadata.clear();
@@ -319,4 +353,22 @@ void Fragmentation::loadModel(const std::string& path)
 void Fragmentation::rebuildGrid(FractureParameters& fractureParameters)
 {
 	_meshGrid->resetFilling();
+}
+
+std::string Fragmentation::saveFragment(AssimpModel* model, const std::string& filename, ZipArchive& archive, bool compress)
+{
+	// Entries keep the folder of their model, as if the folder itself had been compressed
+	const std::filesystem::path path(filename);
+	const std::string entryName = path.parent_path().filename().string() + "/" + path.filename().string();
+
+	// Quantized fragments are snapped to a sixteenth of a voxel. Fragments are smoothed and simplified before being saved, so vertices are 
+	// off that lattice and the encoding is lossy: each coordinate moves by at most half a step (1/32 of a voxel)
+	const MeshCodec::Quantization quantization{ _meshGrid->getAABB().min(), _meshGrid->getCellSize() / 16.0f };
+
+	if (archive.isOpen() && model->save(archive, entryName, &quantization))
+		return archive.getFilename() + "/" + entryName;
+
+	model->save(filename, compress, &quantization);
+
+	return filename;
 }
\ No newline at end of file
@@ -8,6 +8,7 @@
 class FractureParameters;
 class FragmentationProcedure;
 class PointCloud3D;
+class ZipArchive;
 
 /**
 *	@brief Scene composed of CAD models for the manuscript of this work.
@@ -52,11 +53,6 @@ protected:
 	*/
 	std::string fractureModel(FractureParameters& fractParameters);
 
-	/**
-	*	@brief Saves the whole folder into another one.
-	*/
-	void launchZipingProcess(const std::string& folder);
-
 	/**
 	*	@brief Loads the models which are necessary to render the scene.
 	*/
@@ -72,6 +68,12 @@ protected:
 	*/
 	void rebuildGrid(FractureParameters& fractParameters);
 
+	/**
+	*	@brief Saves a fragment into the archive of its model, or into its own file if the archive is not open or the format cannot be archived.
+	*	@return Path of the saved fragment, given as the path of the archive followed by the entry name if it was archived.
+	*/
+	std::string saveFragment(AssimpModel* model, const std::string& filename, ZipArchive& archive, bool compress);
+
 public:
 	/**
 	*	@brief Default constructor.
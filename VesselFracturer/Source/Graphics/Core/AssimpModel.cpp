@@ -1,9 +1,17 @@
 #include "stdafx.h"
 #include "AssimpModel.h"
 
+#include "DataStructures/MeshCache.h"
+#include "Graphics/Core/BinaryMeshSink.h"
+#include "Graphics/Core/MeshReader.h"
+#include "Graphics/Core/MeshSink.h"
+#include "Graphics/Core/QuadricSimplifier.h"
 #include "Graphics/Core/ShaderList.h"
-#include "quadric-mesh-simplification/Simplify.h"
 #include "Utilities/ChronoUtilities.h"
+#include "Utilities/WriterPool.h"
+#include "Utilities/ZipArchive.h"
+
+#include <cfloat>
 
 const std::string AssimpModel::BINARY_EXTENSION = ".bin";
 
@@ -14,20 +22,22 @@ AssimpModel::AssimpModel(const std::string& filename, const bool useBinary, cons
 {
 	std::string binaryFile = _filename.substr(0, _filename.find_last_of('.')) + BINARY_EXTENSION;
 
-	if (useBinary && std::filesystem::exists(binaryFile))
-	{
-		this->loadModelFromBinaryFile(binaryFile);
-	}
-	else
+	// Missing, outdated or stale caches are rebuilt from the source file
+	if (!useBinary || !std::filesystem::exists(binaryFile) || !this->loadModelFromBinaryFile(binaryFile))
 	{
-		_scene = _assimpImporter.ReadFile(_filename, aiProcess_JoinIdenticalVertices | aiProcess_Triangulate | aiProcess_GenSmoothNormals);
-		if (!_scene || _scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !_scene->mRootNode)
-			throw std::runtime_error("ERROR::ASSIMP::" + std::string(_assimpImporter.GetErrorString()));
+		// Plain STL, OBJ and PLY files are parsed natively, whereas Assimp takes any other format or variant
+		if (!this->readNative())
+		{
+			_scene = _assimpImporter.ReadFile(_filename, aiProcess_JoinIdenticalVertices | aiProcess_Triangulate | aiProcess_GenSmoothNormals);
+			if (!_scene || _scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !_scene->mRootNode)
+				throw std::runtime_error("ERROR::ASSIMP::" + std::string(_assimpImporter.GetErrorString()));
 
-		std::string shortName = _scene->GetShortFilename(_filename.c_str());
-		std::string folder = _filename.substr(0, _filename.length() - shortName.length());
+			std::string shortName = _scene->GetShortFilename(_filename.c_str());
+			std::string folder = _filename.substr(0, _filename.length() - shortName.length());
+
+			this->processNode(_scene->mRootNode, _scene, folder);
+		}
 
-		this->processNode(_scene->mRootNode, _scene, folder);
 		if (fuseComponents and _modelComp.size() > 1)
 			this->fuseComponents();
 
@@ -146,49 +156,44 @@ PointCloud3D* AssimpModel::sample(unsigned maxSamples, int randomFunction)
 	return pointCloud;
 }
 
-bool AssimpModel::save(const std::string& filename, bool compress)
+bool AssimpModel::save(const std::string& filename, bool compress, const MeshCodec::Quantization* quantization)
 {
+	BinaryMeshSink::Format format;
+	if (BinaryMeshSink::getFormat(filename, format))
+	{
+		BinaryMeshSink sink(filename, format, true);
+		if (quantization) sink.setQuantization(*quantization);
+
+		return this->write(sink);
+	}
+
 	return this->saveAssimp(filename, compress);
 }
 
-void AssimpModel::simplify(unsigned numFaces, bool verbose)
+bool AssimpModel::save(ZipArchive& archive, const std::string& entryName, const MeshCodec::Quantization* quantization)
 {
-	for (Model3D::ModelComponent* modelComponent : _modelComp)
-	{
-		if (modelComponent->_topology.size() > numFaces)
-		{
-			Simplify::vertices.resize(modelComponent->_geometry.size());
-			Simplify::triangles.resize(modelComponent->_topology.size());
+	BinaryMeshSink::Format format;
+	if (!archive.isOpen() || !BinaryMeshSink::getFormat(entryName, format)) return false;
 
-#pragma omp parallel for
-			for (int i = 0; i < modelComponent->_geometry.size(); ++i)
-				Simplify::vertices[i] = Simplify::Vertex{
-					vec3f(modelComponent->_geometry[i]._position.x, modelComponent->_geometry[i]._position.y, modelComponent->_geometry[i]._position.z)
-			};
+	BinaryMeshSink sink(&archive, entryName, format);
+	if (quantization) sink.setQuantization(*quantization);
 
-#pragma omp parallel for
-			for (int i = 0; i < modelComponent->_topology.size(); ++i)
-			{
-				Simplify::triangles[i] = Simplify::Triangle();
-				for (int j = 0; j < 3; ++j)
-					Simplify::triangles[i].v[j] = modelComponent->_topology[i]._vertices[j];
-			}
-
-			Simplify::simplify_mesh(numFaces, 5.0);
+	return this->write(sink);
+}
 
-			modelComponent->_geometry.resize(Simplify::vertices.size());
-			modelComponent->_topology.resize(Simplify::triangles.size());
+void AssimpModel::simplify(unsigned numFaces, bool verbose)
+{
+	// Buffers are kept alive along the thread, so that consecutive fragments do not reallocate them
+	thread_local QuadricSimplifier simplifier;
 
-#pragma omp parallel for
-			for (int i = 0; i < Simplify::vertices.size(); ++i)
-				modelComponent->_geometry[i]._position = vec3(Simplify::vertices[i].p.x, Simplify::vertices[i].p.y, Simplify::vertices[i].p.z);
+	this->simplify(numFaces, simplifier, verbose);
+}
 
-#pragma omp parallel for
-			for (int i = 0; i < Simplify::triangles.size(); ++i)
-			{
-				modelComponent->_topology[i]._vertices = uvec3(Simplify::triangles[i].v[0], Simplify::triangles[i].v[1], Simplify::triangles[i].v[2]);
-			}
-		}
+void AssimpModel::simplify(unsigned numFaces, QuadricSimplifier& simplifier, bool verbose)
+{
+	for (Model3D::ModelComponent* modelComponent : _modelComp)
+	{
+		simplifier.simplify(modelComponent, numFaces);
 
 		if (verbose)
 			std::cout << "Simplified to " << modelComponent->_topology.size() << " faces." << std::endl;
@@ -212,6 +217,53 @@ bool AssimpModel::subdivide(float maxArea)
 	return applyChanges;
 }
 
+bool AssimpModel::write(MeshSink& sink) const
+{
+	const size_t batchSize = 1 << 12;
+	size_t numVertices = 0, numFaces = 0;
+
+	for (const ModelComponent* modelComponent : _modelComp)
+	{
+		numVertices += modelComponent->_geometry.size();
+		numFaces += modelComponent->_topology.size();
+	}
+
+	if (!sink.begin(numVertices, numFaces)) return false;
+
+	// Components are converted in small batches, so that the GPU layout is never copied as a whole
+	std::vector<vec4> vertices(batchSize);
+	std::vector<uvec4> faces(batchSize);
+
+	for (const ModelComponent* modelComponent : _modelComp)
+	{
+		for (size_t first = 0; first < modelComponent->_geometry.size(); first += batchSize)
+		{
+			const size_t count = std::min(batchSize, modelComponent->_geometry.size() - first);
+			for (size_t vertexIdx = 0; vertexIdx < count; ++vertexIdx)
+				vertices[vertexIdx] = vec4(modelComponent->_geometry[first + vertexIdx]._position, .0f);
+
+			sink.writeVertices(vertices.data(), count);
+		}
+	}
+
+	unsigned baseIndex = 0;
+	for (const ModelComponent* modelComponent : _modelComp)
+	{
+		for (size_t first = 0; first < modelComponent->_topology.size(); first += batchSize)
+		{
+			const size_t count = std::min(batchSize, modelComponent->_topology.size() - first);
+			for (size_t faceIdx = 0; faceIdx < count; ++faceIdx)
+				faces[faceIdx] = uvec4(modelComponent->_topology[first + faceIdx]._vertices + baseIndex, 0);
+
+			sink.writeFaces(faces.data(), count);
+		}
+
+		baseIndex += unsigned(modelComponent->_geometry.size());
+	}
+
+	return sink.end();
+}
+
 /// [Protected methods]
 
 void AssimpModel::fuseComponents()
@@ -238,21 +290,96 @@ void AssimpModel::fuseComponents()
 void AssimpModel::fuseVertices(std::vector<int>& mapping)
 {
 	Model3D::ModelComponent* modelComp = _modelComp[0];
+	const int numVertices = static_cast<int>(modelComp->_geometry.size());
+	const float epsilon = glm::epsilon<float>();
 
-	for (unsigned vertexIdx = 0; vertexIdx < modelComp->_geometry.size(); ++vertexIdx)
-	{
-		if (mapping[vertexIdx] != vertexIdx)
-			continue;
+	if (numVertices == 0) return;
+
+	// Hashed grid whose cells hold a few vertices on average, but are never smaller than twice the welding distance
+	AABB aabb;
+	for (const VertexGPUData& vertex : modelComp->_geometry)
+		aabb.update(vertex._position);
+
+	const vec3 size = aabb.size();
+	const double cellSize = std::max(2.0 * epsilon, double(glm::max(size.x, glm::max(size.y, size.z))) / std::cbrt(double(numVertices)));
+	auto getCell = [cellSize](const vec3& position) { return glm::i64vec3(glm::floor(glm::dvec3(position) / cellSize)); };
+
+	size_t numBuckets = 1;
+	while (numBuckets < 2 * size_t(numVertices)) numBuckets <<= 1;
+
+	auto getBucket = [numBuckets](const glm::i64vec3& cell) {
+		uint64_t hash = uint64_t(cell.x) * 73856093ull ^ uint64_t(cell.y) * 19349663ull ^ uint64_t(cell.z) * 83492791ull;
+		hash ^= hash >> 29;
+		return unsigned(hash & (numBuckets - 1));
+	};
+
+	std::vector<unsigned> vertexBucket(numVertices), bucketOffset(numBuckets + 1, 0), bucketVertices(numVertices);
 
 #pragma omp parallel for
-		for (int j = vertexIdx + 1; j < modelComp->_geometry.size(); ++j)
+	for (int vertexIdx = 0; vertexIdx < numVertices; ++vertexIdx)
+		vertexBucket[vertexIdx] = getBucket(getCell(modelComp->_geometry[vertexIdx]._position));
+
+	// CSR layout of vertices per bucket, sorted by index within each bucket
+	for (int vertexIdx = 0; vertexIdx < numVertices; ++vertexIdx)
+		++bucketOffset[vertexBucket[vertexIdx] + 1];
+
+	std::partial_sum(bucketOffset.begin(), bucketOffset.end(), bucketOffset.begin());
+
+	std::vector<unsigned> bucketCursor(bucketOffset.begin(), bucketOffset.end() - 1);
+	for (int vertexIdx = 0; vertexIdx < numVertices; ++vertexIdx)
+		bucketVertices[bucketCursor[vertexBucket[vertexIdx]]++] = vertexIdx;
+
+	bucketCursor = std::vector<unsigned>();
+	vertexBucket = std::vector<unsigned>();
+
+	// Greatest previous vertex closer than epsilon, optionally restricted to vertices which were not fused
+	auto findPrevious = [&](int vertexIdx, bool onlyUnmapped) {
+		const vec3& position = modelComp->_geometry[vertexIdx]._position;
+		const glm::dvec3 cellPosition = glm::dvec3(position) / cellSize;
+		const glm::i64vec3 cell = glm::i64vec3(glm::floor(cellPosition));
+		int previous = -1;
+
+		// Neighbour cells are only visited along the axes where the vertex lies within epsilon of a face
+		ivec3 firstOffset, lastOffset;
+		for (int axis = 0; axis < 3; ++axis)
 		{
-			if (mapping[vertexIdx] == vertexIdx && glm::distance(modelComp->_geometry[vertexIdx]._position, modelComp->_geometry[j]._position) < glm::epsilon<float>())
-			{
-				// Remap
-				mapping[j] = vertexIdx;
-			}
+			const double local = (cellPosition[axis] - std::floor(cellPosition[axis])) * cellSize;
+			firstOffset[axis] = local <= epsilon ? -1 : 0;
+			lastOffset[axis] = cellSize - local <= epsilon ? 1 : 0;
 		}
+
+		for (int x = firstOffset.x; x <= lastOffset.x; ++x)
+			for (int y = firstOffset.y; y <= lastOffset.y; ++y)
+				for (int z = firstOffset.z; z <= lastOffset.z; ++z)
+				{
+					const unsigned bucket = getBucket(cell + glm::i64vec3(x, y, z));
+					for (unsigned offset = bucketOffset[bucket]; offset < bucketOffset[bucket + 1] && int(bucketVertices[offset]) < vertexIdx; ++offset)
+					{
+						const int candidate = int(bucketVertices[offset]);
+						if (candidate > previous && (!onlyUnmapped || mapping[candidate] == candidate) && glm::distance(position, modelComp->_geometry[candidate]._position) < epsilon)
+							previous = candidate;
+					}
+				}
+
+		return previous;
+	};
+
+	// Vertices without any close predecessor keep their own index, which is the common case and can be decided concurrently
+	std::vector<char> hasPrevious(numVertices);
+
+#pragma omp parallel for
+	for (int vertexIdx = 0; vertexIdx < numVertices; ++vertexIdx)
+		hasPrevious[vertexIdx] = findPrevious(vertexIdx, false) >= 0;
+
+	// Remaining vertices are fused in order, each one into the last unmapped vertex within epsilon, as the exhaustive search did
+	for (int vertexIdx = 0; vertexIdx < numVertices; ++vertexIdx)
+	{
+		if (!hasPrevious[vertexIdx])
+			continue;
+
+		const int previous = findPrevious(vertexIdx, true);
+		if (previous >= 0)
+			mapping[vertexIdx] = previous;
 	}
 }
 
@@ -270,23 +397,38 @@ Model3D::ModelComponent* AssimpModel::processMesh(aiMesh* mesh, const aiScene* s
 
 	// Vertices
 	int numVertices = static_cast<int>(mesh->mNumVertices);
+	vec3 minPoint(INFINITY), maxPoint(-INFINITY);
 
-#pragma omp parallel for
-	for (int i = 0; i < numVertices; i++)
+#pragma omp parallel
 	{
-		Model3D::VertexGPUData vertex;
-		vertex._position = vec3(mesh->mVertices[i].x, mesh->mVertices[i].y, mesh->mVertices[i].z);
-		vertex._normal = vec3(mesh->mNormals[i].x, mesh->mNormals[i].y, mesh->mNormals[i].z);
+		vec3 localMin(INFINITY), localMax(-INFINITY);
 
-		if (mesh->mTangents) vertex._tangent = vec3(mesh->mTangents[i].x, mesh->mTangents[i].y, mesh->mTangents[i].z);
-		if (mesh->mTextureCoords[0]) vertex._textCoord = vec2(mesh->mTextureCoords[0][i].x, mesh->mTextureCoords[0][i].y);
+#pragma omp for nowait
+		for (int i = 0; i < numVertices; i++)
+		{
+			Model3D::VertexGPUData vertex;
+			vertex._position = vec3(mesh->mVertices[i].x, mesh->mVertices[i].y, mesh->mVertices[i].z);
+			vertex._normal = vec3(mesh->mNormals[i].x, mesh->mNormals[i].y, mesh->mNormals[i].z);
+
+			if (mesh->mTangents) vertex._tangent = vec3(mesh->mTangents[i].x, mesh->mTangents[i].y, mesh->mTangents[i].z);
+			if (mesh->mTextureCoords[0]) vertex._textCoord = vec2(mesh->mTextureCoords[0][i].x, mesh->mTextureCoords[0][i].y);
 
-		vertices[i] = vertex;
+			vertices[i] = vertex;
 
+			localMin = glm::min(localMin, vertex._position);
+			localMax = glm::max(localMax, vertex._position);
+		}
+
+		// Boundaries are merged once per thread
 #pragma omp critical
-		aabb.update(vertex._position);
+		{
+			minPoint = glm::min(minPoint, localMin);
+			maxPoint = glm::max(maxPoint, localMax);
+		}
 	}
 
+	if (numVertices) aabb = AABB(minPoint, maxPoint);
+
 	// Indices
 #pragma omp parallel for
 	for (int i = 0; i < mesh->mNumFaces; i++)
@@ -303,6 +445,53 @@ Model3D::ModelComponent* AssimpModel::processMesh(aiMesh* mesh, const aiScene* s
 	return component;
 }
 
+bool AssimpModel::readNative()
+{
+	MeshReader meshReader;
+	if (!meshReader.read(_filename)) return false;
+
+	const std::vector<vec3>& positions = meshReader.getPositions();
+	const std::vector<uvec3>& faces = meshReader.getFaces();
+	const int numVertices = static_cast<int>(positions.size()), numFaces = static_cast<int>(faces.size());
+
+	ModelComponent* component = new ModelComponent;
+	component->_geometry.resize(numVertices);
+	component->_topology.resize(numFaces);
+	component->_aabb = meshReader.getAABB();
+
+	// Smooth normals, weighted by the area of the adjacent triangles, as requested from Assimp
+	std::vector<vec3> normals(numVertices, vec3(.0f));
+
+	for (int faceIdx = 0; faceIdx < numFaces; ++faceIdx)
+	{
+		const uvec3& face = faces[faceIdx];
+		const vec3 normal = glm::cross(positions[face.y] - positions[face.x], positions[face.z] - positions[face.x]);
+
+		for (int vertex = 0; vertex < 3; ++vertex)
+			normals[face[vertex]] += normal;
+	}
+
+#pragma omp parallel for
+	for (int vertexIdx = 0; vertexIdx < numVertices; ++vertexIdx)
+	{
+		Model3D::VertexGPUData& vertex = component->_geometry[vertexIdx];
+		const float length = glm::length(normals[vertexIdx]);
+
+		vertex._position = positions[vertexIdx];
+		vertex._normal = length > .0f ? normals[vertexIdx] / length : vec3(.0f);
+		vertex._textCoord = vec2(.0f);
+	}
+
+#pragma omp parallel for
+	for (int faceIdx = 0; faceIdx < numFaces; ++faceIdx)
+		component->_topology[faceIdx] = Model3D::FaceGPUData{ faces[faceIdx] };
+
+	_modelComp.push_back(component);
+	_aabb.update(component->_aabb);
+
+	return true;
+}
+
 void AssimpModel::processNode(aiNode* node, const aiScene* scene, const std::string& folder)
 {
 	for (unsigned int i = 0; i < node->mNumMeshes; i++)
@@ -320,60 +509,71 @@ void AssimpModel::processNode(aiNode* node, const aiScene* scene, const std::str
 
 bool AssimpModel::readBinary(const std::string& filename, const std::vector<Model3D::ModelComponent*>& modelComp)
 {
-	std::ifstream fin(filename, std::ios::in | std::ios::binary);
-	if (!fin.is_open()) return false;
+	MeshCache meshCache;
+	if (!meshCache.open(filename, MeshCache::getSourceHash(_filename))) return false;
 
-	size_t numModelComps, numVertices, numTriangles, numIndices;
-
-	fin.read((char*)&numModelComps, sizeof(size_t));
-	while (_modelComp.size() < numModelComps)
+	while (_modelComp.size() < meshCache.getNumComponents())
 	{
 		_modelComp.push_back(new ModelComponent());
 	}
 
-	for (Model3D::ModelComponent* component : modelComp)
+	for (unsigned componentIdx = 0; componentIdx < meshCache.getNumComponents(); ++componentIdx)
 	{
-		fin.read((char*)&numVertices, sizeof(size_t));
-		component->_geometry.resize(numVertices);
-		if (numVertices)
-			fin.read((char*)&component->_geometry[0], numVertices * sizeof(Model3D::VertexGPUData));
+		Model3D::ModelComponent* component = modelComp[componentIdx];
+		const vec3* positions = meshCache.getPositions(componentIdx), *normals = meshCache.getNormals(componentIdx);
+		const vec2* textCoords = meshCache.getTextCoords(componentIdx);
+		const uvec3* faces = meshCache.getFaces(componentIdx);
+
+		// Streams are read in place from the mapped file
+		component->_geometry.resize(meshCache.getNumVertices(componentIdx));
+		component->_topology.resize(meshCache.getNumFaces(componentIdx));
 
-		fin.read((char*)&numTriangles, sizeof(size_t));
-		component->_topology.resize(numTriangles);
-		if (numTriangles)
-			fin.read((char*)&component->_topology[0], numTriangles * sizeof(Model3D::FaceGPUData));
+#pragma omp parallel for
+		for (int vertexIdx = 0; vertexIdx < component->_geometry.size(); ++vertexIdx)
+		{
+			Model3D::VertexGPUData vertex = Model3D::VertexGPUData{ positions[vertexIdx] };
+			if (normals) vertex._normal = normals[vertexIdx];
+			if (textCoords) vertex._textCoord = textCoords[vertexIdx];
+
+			component->_geometry[vertexIdx] = vertex;
+		}
 
-		fin.read((char*)&component->_aabb, sizeof(AABB));
+#pragma omp parallel for
+		for (int faceIdx = 0; faceIdx < component->_topology.size(); ++faceIdx)
+			component->_topology[faceIdx] = Model3D::FaceGPUData{ faces[faceIdx] };
+
+		component->_aabb = meshCache.getAABB(componentIdx);
 	}
 
-	fin.read((char*)&_aabb, sizeof(AABB));
-	fin.close();
+	_aabb = meshCache.getAABB();
 
 	return true;
 }
 
 void AssimpModel::remapVertices(Model3D::ModelComponent* modelComponent, std::vector<int>& mapping)
 {
-	unsigned erasedVertices = 0, startingSize = modelComponent->_geometry.size();
-	std::vector<unsigned> newMapping(startingSize);
+	const int numVertices = static_cast<int>(modelComponent->_geometry.size());
 
-	for (size_t vertexIdx = 0; vertexIdx < startingSize; ++vertexIdx)
-	{
-		newMapping[vertexIdx] = vertexIdx - erasedVertices;
+	// Prefix sum of kept vertices, which gives the compacted index of each one
+	std::vector<unsigned> newMapping(numVertices + 1, 0);
+	for (int vertexIdx = 0; vertexIdx < numVertices; ++vertexIdx)
+		newMapping[vertexIdx + 1] = newMapping[vertexIdx] + unsigned(mapping[vertexIdx] == vertexIdx);
 
-		if (mapping[vertexIdx] != vertexIdx)
-		{
-			modelComponent->_geometry.erase(modelComponent->_geometry.begin() + vertexIdx - erasedVertices);
-			++erasedVertices;
-		}
-	}
+	std::vector<VertexGPUData> geometry(newMapping[numVertices]);
+
+#pragma omp parallel for
+	for (int vertexIdx = 0; vertexIdx < numVertices; ++vertexIdx)
+		if (mapping[vertexIdx] == vertexIdx)
+			geometry[newMapping[vertexIdx]] = modelComponent->_geometry[vertexIdx];
 
-	for (FaceGPUData& face : modelComponent->_topology)
+	modelComponent->_geometry = std::move(geometry);
+
+#pragma omp parallel for
+	for (int faceIdx = 0; faceIdx < modelComponent->_topology.size(); ++faceIdx)
 	{
+		FaceGPUData& face = modelComponent->_topology[faceIdx];
 		for (int i = 0; i < 3; ++i)
-		{
 			face._vertices[i] = newMapping[mapping[face._vertices[i]]];
-		}
 	}
 }
 
@@ -444,49 +644,23 @@ bool AssimpModel::saveAssimp(const std::string& filename, bool compress)
 		face.mIndices[2] = faces[i].z;
 	}
 
-	// Out of main thread
-	std::thread writeModel(&AssimpModel::threadedSaveAssimp, this, scene, filename, compress);
-	writeModel.detach();
+	// Out of main thread, sized as a binary STL for backpressure
+	WriterPool::getInstance()->submit([scene, filename, compress]() { return AssimpModel::threadedSaveAssimp(scene, filename, compress); }, 84 + faces.size() * 50);
 
 	return true;
 }
 
-void AssimpModel::threadedSaveAssimp(aiScene* scene, const std::string& filename, bool zip)
+bool AssimpModel::threadedSaveAssimp(aiScene* scene, const std::string& filename, bool zip)
 {
-	const std::string file = filename.substr(filename.find_last_of('/') + 1);
 	Assimp::Exporter exporter;
-	exporter.Export(scene, "stl", filename);
+	const bool success = exporter.Export(scene, "stl", filename) == AI_SUCCESS;
 	delete scene;
+
+	return success;
 }
 
 bool AssimpModel::writeBinary(const std::string& path)
 {
-	std::ofstream fout(path, std::ios::out | std::ios::binary);
-	if (!fout.is_open())
-	{
-		return false;
-	}
-
-	size_t numIndices;
-	const size_t numModelComps = _modelComp.size();
-	fout.write((char*)&numModelComps, sizeof(size_t));
-
-	for (Model3D::ModelComponent* component : _modelComp)
-	{
-		const size_t numVertices = component->_geometry.size();
-		fout.write((char*)&numVertices, sizeof(size_t));
-		fout.write((char*)&component->_geometry[0], numVertices * sizeof(Model3D::VertexGPUData));
-
-		const size_t numTriangles = component->_topology.size();
-		fout.write((char*)&numTriangles, sizeof(size_t));
-		fout.write((char*)&component->_topology[0], numTriangles * sizeof(Model3D::FaceGPUData));
-
-		fout.write((char*)(&component->_aabb), sizeof(AABB));
-	}
-
-	fout.write((char*)&_aabb, sizeof(AABB));
-
-	fout.close();
-
-	return true;
+	// Fracturing only needs positions and indices, normals are kept for rendering
+	return MeshCache::write(path, MeshCache::getSourceHash(_filename), _modelComp, _aabb, MeshCache::NORMALS);
 }
\ No newline at end of file
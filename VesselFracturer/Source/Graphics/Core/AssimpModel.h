@@ -6,8 +6,13 @@
 #include <assimp/postprocess.h>
 #include "Fracturer/Seeder.h"
 #include "Geometry/3D/PointCloud3D.h"
+#include "Graphics/Core/MeshCodec.h"
 #include "Graphics/Core/Model3D.h"
 
+class MeshSink;
+class QuadricSimplifier;
+class ZipArchive;
+
 /**
 *	@brief Model loaded from an OBJ file.
 */
@@ -50,7 +55,13 @@ protected:
 	void processNode(aiNode* node, const aiScene* scene, const std::string& folder);
 
 	/**
-	*	@brief Loads the CAD model from a binary file, if possible.
+	*	@brief Loads positions and triangles of STL, OBJ and PLY files without Assimp.
+	*	@return False if the format or any of its features is not supported.
+	*/
+	bool readNative();
+
+	/**
+	*	@brief Loads the CAD model from a memory-mapped binary cache, if it is valid for the source file.
 	*/
 	bool readBinary(const std::string& filename, const std::vector<Model3D::ModelComponent*>& modelComp);
 
@@ -65,9 +76,9 @@ protected:
 	bool saveAssimp(const std::string& filename, bool compress = true);
 
 	/**
-	*	@brief Saves current model using assimp.
+	*	@brief Exports a scene using assimp and releases it. Executed by the writer pool.
 	*/
-	void threadedSaveAssimp(aiScene* scene, const std::string& filename, bool zip);
+	static bool threadedSaveAssimp(aiScene* scene, const std::string& filename, bool zip);
 
 	/**
 	*	@brief Writes the model to a binary file in order to fasten the following executions.
@@ -131,18 +142,36 @@ public:
 	PointCloud3D* sample(unsigned maxSamples, int randomFunction);
 
 	/**
-	*	@brief Saves the model using assimp.
+	*	@brief Saves the model. Binary STL, PLY and quantized files are written natively with a single buffered write, other formats through assimp.
+	*	@param quantization Grid of quantized files, fitted to the model if not given.
+	*/
+	bool save(const std::string& filename, bool compress = true, const MeshCodec::Quantization* quantization = nullptr);
+
+	/**
+	*	@brief Adds the model to an archive as a binary STL, PLY or quantized file, compressed by the writer pool.
+	*	@param quantization Grid of quantized files, fitted to the model if not given.
+	*	@return False if the format of the entry is not supported or the archive is not open.
 	*/
-	bool save(const std::string& filename, bool compress = true);
+	bool save(ZipArchive& archive, const std::string& entryName, const MeshCodec::Quantization* quantization = nullptr);
 
 	/**
-	*	@brief
+	*	@brief Decimates every component down to the given number of faces, using a simplifier owned by the calling thread.
 	*/
 	void simplify(unsigned numFaces, bool verbose = false);
 
+	/**
+	*	@brief Decimates every component down to the given number of faces with the working buffers of the given simplifier.
+	*/
+	void simplify(unsigned numFaces, QuadricSimplifier& simplifier, bool verbose = false);
+
 	/**
 	*	@brief Subdivides mesh with the specified maximum area.
 	*/
 	bool subdivide(float maxArea);
+
+	/**
+	*	@brief Streams the geometry and topology of every component into a sink, as a single mesh.
+	*/
+	bool write(MeshSink& sink) const;
 };
 
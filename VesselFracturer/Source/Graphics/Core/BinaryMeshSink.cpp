@@ -0,0 +1,202 @@
+#include "stdafx.h"
+#include "BinaryMeshSink.h"
+
+#include "Graphics/Core/MeshCodec.h"
+
+#include "Utilities/WriterPool.h"
+#include "Utilities/ZipArchive.h"
+
+// [Static attributes]
+
+const size_t BinaryMeshSink::MAX_BUFFER_SIZE = 1 << 26;
+
+// [Public methods]
+
+BinaryMeshSink::BinaryMeshSink(const std::string& filename, Format format, bool deferred) :
+	_archive(nullptr), _bufferSize(0), _deferred(deferred), _failed(false), _filename(filename), _format(format), _numFaces(0), _numVertices(0), _numWrittenFaces(0), _numWrittenVertices(0), _pooled(false), _quantization{ vec3(.0f), vec3(.0f) }
+{
+}
+
+BinaryMeshSink::BinaryMeshSink(ZipArchive* archive, const std::string& name, Format format) :
+	_archive(archive), _bufferSize(0), _deferred(true), _failed(false), _filename(name), _format(format), _numFaces(0), _numVertices(0), _numWrittenFaces(0), _numWrittenVertices(0), _pooled(false), _quantization{ vec3(.0f), vec3(.0f) }
+{
+}
+
+BinaryMeshSink::~BinaryMeshSink()
+{
+	if (_stream.is_open())
+		_stream.close();
+}
+
+bool BinaryMeshSink::getFormat(const std::string& filename, Format& format)
+{
+	std::string extension = std::filesystem::path(filename).extension().string();
+	std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char character) { return std::tolower(character); });
+
+	if (extension == ".ply")
+		format = PLY;
+	else if (extension == MeshCodec::EXTENSION)
+		format = QUANTIZED;
+	else if (extension == ".stl")
+		format = STL;
+	else
+		return false;
+
+	return true;
+}
+
+bool BinaryMeshSink::begin(size_t numVertices, size_t numFaces)
+{
+	if (_stream.is_open())
+		_stream.close();
+
+	_failed = false;
+	_numVertices = numVertices;
+	_numFaces = numFaces;
+	_numWrittenFaces = 0;
+	_numWrittenVertices = 0;
+	_faces.clear();
+	_positions.clear();
+
+	if (_format != PLY && numFaces > std::numeric_limits<uint32_t>::max()) return false;
+
+	// The whole file is gathered at once unless it exceeds the maximum buffer size, whereas archive entries and quantized meshes are 
+	// always complete, as the latter are encoded once every face is known
+	const size_t headerSize = 512;												// Upper bound of the PLY header
+	const size_t fileSize = _format == STL ? 84 + numFaces * 50 : (_format == PLY ? headerSize + numVertices * sizeof(vec3) + numFaces * (1 + sizeof(uvec3)) : 0);
+	_bufferSize = _archive ? fileSize : std::min(fileSize, MAX_BUFFER_SIZE);
+	_pooled = _archive || (_deferred && (_format == QUANTIZED || fileSize <= MAX_BUFFER_SIZE));
+	_buffer.clear();
+
+	if (!_pooled)
+	{
+		_stream.open(_filename, std::ios::out | std::ios::binary | std::ios::trunc);
+		if (!_stream.is_open()) return false;
+	}
+
+	_buffer.reserve(_bufferSize);
+
+	if (_format == STL)
+	{
+		char header[80] = "Binary STL";
+		_buffer.insert(_buffer.end(), header, header + sizeof(header));
+		this->push(uint32_t(numFaces));
+
+		_positions.reserve(numVertices);
+	}
+	else if (_format == QUANTIZED)
+	{
+		_faces.reserve(numFaces);
+		_positions.reserve(numVertices);
+	}
+	else
+	{
+		const std::string header =
+			"ply\nformat binary_little_endian 1.0\n"
+			"element vertex " + std::to_string(numVertices) + "\nproperty float x\nproperty float y\nproperty float z\n"
+			"element face " + std::to_string(numFaces) + "\nproperty list uchar uint vertex_indices\nend_header\n";
+		_buffer.insert(_buffer.end(), header.begin(), header.end());
+	}
+
+	return true;
+}
+
+bool BinaryMeshSink::end()
+{
+	// Every format must match the sizes announced by begin, e.g. the PLY header is written before any vertex
+	const bool complete = !_failed && _numWrittenFaces == _numFaces && _numWrittenVertices == _numVertices;
+
+	if (_format == QUANTIZED)
+	{
+		if (complete)
+			MeshCodec::encode(_positions, _faces, _quantization, _buffer);
+
+		_faces = std::vector<uvec3>();
+	}
+
+	if (_pooled)
+	{
+		bool success = complete;
+		if (success && _archive)
+			success = _archive->add(_filename, std::move(_buffer));
+		else if (success)
+			WriterPool::getInstance()->write(_filename, std::move(_buffer));
+
+		_pooled = false;
+		_positions = std::vector<vec3>();
+		_buffer = std::vector<char>();
+
+		return success;
+	}
+
+	if (!_stream.is_open()) return false;
+
+	this->flush();
+	_stream.close();
+	_positions = std::vector<vec3>();
+	_buffer = std::vector<char>();
+
+	return complete && !_stream.fail();
+}
+
+void BinaryMeshSink::writeFaces(const uvec4* faces, size_t numFaces)
+{
+	for (size_t faceIdx = 0; faceIdx < numFaces; ++faceIdx)
+	{
+		const uvec4& face = faces[faceIdx];
+
+		const size_t numVertices = _format == PLY ? _numVertices : _positions.size();
+		if (face.x >= numVertices || face.y >= numVertices || face.z >= numVertices)
+		{
+			_failed = true;
+			continue;
+		}
+
+		if (_format == STL)
+		{
+			const vec3 &v1 = _positions[face.x], &v2 = _positions[face.y], &v3 = _positions[face.z];
+			const vec3 normal = glm::cross(v2 - v1, v3 - v1);
+			const float length = glm::length(normal);
+
+			this->push(length > .0f ? normal / length : vec3(.0f));
+			this->push(v1);
+			this->push(v2);
+			this->push(v3);
+			this->push(uint16_t(0));
+		}
+		else if (_format == QUANTIZED)
+		{
+			_faces.push_back(uvec3(face));
+		}
+		else
+		{
+			this->push(uint8_t(3));
+			this->push(uvec3(face));
+		}
+	}
+
+	_numWrittenFaces += numFaces;
+}
+
+void BinaryMeshSink::writeVertices(const vec4* vertices, size_t numVertices)
+{
+	for (size_t vertexIdx = 0; vertexIdx < numVertices; ++vertexIdx)
+	{
+		if (_format != PLY)
+			_positions.push_back(vec3(vertices[vertexIdx]));
+		else
+			this->push(vec3(vertices[vertexIdx]));
+	}
+
+	_numWrittenVertices += numVertices;
+}
+
+// [Protected methods]
+
+void BinaryMeshSink::flush()
+{
+	if (!_buffer.empty())
+		_stream.write(_buffer.data(), _buffer.size());
+
+	_buffer.clear();
+}
@@ -0,0 +1,117 @@
+#pragma once
+
+#include "Graphics/Core/MeshCodec.h"
+#include "Graphics/Core/MeshSink.h"
+
+class ZipArchive;
+
+/**
+*	@file BinaryMeshSink.h
+*	@authors Alfonso Lpez Ruiz (alr00048@red.ujaen.es)
+*	@date 19/10/2026
+*/
+
+/**
+*	@brief Streams a mesh into a binary STL, PLY or quantized (MeshCodec) file through a buffer. Headers are written as soon as the 
+*	sizes are known, so no seeking is needed, and files up to the maximum buffer size are written with a single call. STL triangles 
+*	are not indexed, hence only positions are retained until the faces are written, whereas quantized meshes are retained as a whole 
+*	and encoded at the end. Deferred sinks hand the finished file to the writer pool instead of writing it themselves, as long as it 
+*	fits in the buffer. Archived meshes are always gathered and become an entry of a ZIP archive.
+*/
+class BinaryMeshSink : public MeshSink
+{
+public:
+	enum Format { PLY, STL, QUANTIZED };
+
+protected:
+	static const size_t		MAX_BUFFER_SIZE;			//!< Maximum number of bytes gathered before writing them into the file
+
+protected:
+	ZipArchive*				_archive;					//!< Archive which receives the file, if any
+	std::vector<char>		_buffer;					//!< Bytes pending to be written
+	size_t					_bufferSize;				//!< Capacity of the buffer for the current file
+	bool					_deferred;					//!< The file is written by the writer pool
+	bool					_failed;					//!< An error was found while writing the current mesh
+	std::vector<uvec3>		_faces;						//!< Faces of quantized meshes
+	std::string				_filename;					//!< Path of the output file, or name of the archive entry
+	Format					_format;					//!< File format
+	size_t					_numFaces;					//!< Number of faces announced by begin
+	size_t					_numVertices;				//!< Number of vertices announced by begin
+	size_t					_numWrittenFaces;			//!< Number of faces written so far
+	size_t					_numWrittenVertices;		//!< Number of vertices written so far
+	bool					_pooled;					//!< The current file is gathered in memory and queued into the writer pool
+	std::vector<vec3>		_positions;					//!< Positions of STL and quantized vertices, needed to expand or encode every face
+	MeshCodec::Quantization	_quantization;				//!< Grid of quantized positions
+	std::ofstream			_stream;					//!< Output file
+
+protected:
+	/**
+	*	@brief Writes the pending bytes into the file.
+	*/
+	void flush();
+
+	/**
+	*	@brief Appends the bytes of a value to the buffer.
+	*/
+	template<typename T>
+	void push(const T& value);
+
+public:
+	/**
+	*	@brief Constructor.
+	*	@param deferred The file is queued into the writer pool once finished, so that the caller does not wait for the disk.
+	*/
+	BinaryMeshSink(const std::string& filename, Format format, bool deferred = false);
+
+	/**
+	*	@brief Constructor of a sink whose meshes are added to an archive.
+	*	@param name Path of the entry within the archive.
+	*/
+	BinaryMeshSink(ZipArchive* archive, const std::string& name, Format format);
+
+	/**
+	*	@brief Destructor. Closes the file if the mesh was not finished.
+	*/
+	virtual ~BinaryMeshSink();
+
+	/**
+	*	@brief Deduces the file format from the extension of the filename.
+	*	@return False if the extension is not supported.
+	*/
+	static bool getFormat(const std::string& filename, Format& format);
+
+	/**
+	*	@brief Opens the file and writes its header.
+	*/
+	virtual bool begin(size_t numVertices, size_t numFaces);
+
+	/**
+	*	@brief Writes the remaining bytes and closes the file, or queues the whole file into the writer pool or the archive.
+	*/
+	virtual bool end();
+
+	/**
+	*	@brief Sets the grid of quantized positions, which is otherwise fitted to the boundaries of every mesh.
+	*/
+	void setQuantization(const MeshCodec::Quantization& quantization) { _quantization = quantization; }
+
+	/**
+	*	@brief Appends faces, which are expanded into triangles with a normal in STL files.
+	*/
+	virtual void writeFaces(const uvec4* faces, size_t numFaces);
+
+	/**
+	*	@brief Appends vertices.
+	*/
+	virtual void writeVertices(const vec4* vertices, size_t numVertices);
+};
+
+template<typename T>
+inline void BinaryMeshSink::push(const T& value)
+{
+	if (_buffer.size() + sizeof(T) > _bufferSize)
+		this->flush();
+
+	const char* bytes = reinterpret_cast<const char*>(&value);
+	_buffer.insert(_buffer.end(), bytes, bytes + sizeof(T));
+}
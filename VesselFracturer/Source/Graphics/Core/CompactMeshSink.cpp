@@ -0,0 +1,42 @@
+#include "stdafx.h"
+#include "CompactMeshSink.h"
+
+// [Public methods]
+
+CompactMeshSink::CompactMeshSink() : _numFaces(0), _numVertices(0)
+{
+}
+
+CompactMeshSink::~CompactMeshSink()
+{
+}
+
+bool CompactMeshSink::begin(size_t numVertices, size_t numFaces)
+{
+	_vertices.clear();
+	_faces.clear();
+	_vertices.reserve(numVertices);
+	_faces.reserve(numFaces);
+
+	_numVertices = numVertices;
+	_numFaces = numFaces;
+
+	return true;
+}
+
+bool CompactMeshSink::end()
+{
+	return _vertices.size() == _numVertices && _faces.size() == _numFaces;
+}
+
+void CompactMeshSink::writeFaces(const uvec4* faces, size_t numFaces)
+{
+	for (size_t faceIdx = 0; faceIdx < numFaces; ++faceIdx)
+		_faces.push_back(uvec3(faces[faceIdx]));
+}
+
+void CompactMeshSink::writeVertices(const vec4* vertices, size_t numVertices)
+{
+	for (size_t vertexIdx = 0; vertexIdx < numVertices; ++vertexIdx)
+		_vertices.push_back(vec3(vertices[vertexIdx]));
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "Graphics/Core/MeshSink.h"
+
+/**
+*	@file CompactMeshSink.h
+*	@authors Alfonso Lpez Ruiz (alr00048@red.ujaen.es)
+*	@date 19/10/2026
+*/
+
+/**
+*	@brief In-memory mesh with bare positions and indices, a fraction of the size of the GPU layout of Model3D.
+*/
+class CompactMeshSink : public MeshSink
+{
+protected:
+	std::vector<uvec3>		_faces;						//!< Vertex indices of each triangle
+	size_t					_numFaces;					//!< Number of faces announced by begin
+	size_t					_numVertices;				//!< Number of vertices announced by begin
+	std::vector<vec3>		_vertices;					//!< Vertex positions
+
+public:
+	/**
+	*	@brief Constructor.
+	*/
+	CompactMeshSink();
+
+	/**
+	*	@brief Destructor.
+	*/
+	virtual ~CompactMeshSink();
+
+	/**
+	*	@brief Starts a new mesh, discarding the previous one.
+	*/
+	virtual bool begin(size_t numVertices, size_t numFaces);
+
+	/**
+	*	@brief Finishes the current mesh.
+	*/
+	virtual bool end();
+
+	/**
+	*	@return Vertex indices of each triangle.
+	*/
+	const std::vector<uvec3>& getFaces() const { return _faces; }
+
+	/**
+	*	@return Vertex positions.
+	*/
+	const std::vector<vec3>& getVertices() const { return _vertices; }
+
+	/**
+	*	@brief Appends faces.
+	*/
+	virtual void writeFaces(const uvec4* faces, size_t numFaces);
+
+	/**
+	*	@brief Appends vertices.
+	*/
+	virtual void writeVertices(const vec4* vertices, size_t numVertices);
+};
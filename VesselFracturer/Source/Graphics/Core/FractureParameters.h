@@ -26,6 +26,15 @@ public:
 	enum NeighbourhoodType { VON_NEUMANN, MOORE, NUM_NEIGHBOURHOODS };
 	inline static const char* Neighbourhood_STR[NUM_NEIGHBOURHOODS] = { "Von Neumann", "Moore" };
 
+	enum VoxelizationType { TETRAVOXELIZER_GPU, TETRAVOXELIZER_CPU, SURFACE_FLOOD, WINDING_NUMBER, NUM_VOXELIZATION_TYPES };
+	inline static const char* Voxelization_STR[NUM_VOXELIZATION_TYPES] = { "Tetravoxelizer (GPU)", "Tetravoxelizer (CPU)", "Surface + exterior flood", "Winding number (robust)" };
+
+	enum MeshingType { MARCHING_CUBES_GPU, MARCHING_CUBES_CPU, SURFACE_NETS, MARCHING_CUBES_SPARSE, NUM_MESHING_TYPES };
+	inline static const char* Meshing_STR[NUM_MESHING_TYPES] = { "Marching cubes (GPU)", "Marching cubes (CPU, multi-label)", "Surface Nets (CPU, multi-label)", "Marching cubes (CPU, active cells)" };
+
+	enum DownsamplingType { CONSERVATIVE, MAJORITY, NUM_DOWNSAMPLING_TYPES };
+	inline static const char* Downsampling_STR[NUM_DOWNSAMPLING_TYPES] = { "Conservative", "Majority" };
+
 public:
 	int				_biasSeeds;
 	int				_boundarySize;
@@ -39,21 +48,27 @@ public:
 	float			_erosionThreshold;
 	bool			_fillShape;
 	int				_distanceFunction;
+	int				_downsamplingType;
 	ivec3			_gridSubdivisions;
 	bool			_launchGPU;
 	int				_marchingCubesSubdivisions;
 	int				_mergeSeedsDistanceFunction;
+	int				_meshingChunkSize;
+	int				_meshingType;
 	bool			_metricVoxelization;
 	int             _neighbourhoodType;
 	int				_numExtraSeeds;
 	int				_numSeeds;
 	int				_numTriangleSamples;
+	bool			_outOfCoreGrid;
 	int				_pointCloudSeedingRandom;
 	bool			_removeIsolatedRegions;
 	int				_seed;
 	int				_seedingRandom;
 	int				_spreading;
 	std::vector<int> _targetTriangles;
+	std::string		_voxelizationCacheFolder;
+	int				_voxelizationType;
 	int				_voxelPerMetricUnit;
 
 	// Rendering during the build procedure
@@ -78,21 +93,27 @@ public:
 		_erosionThreshold(0.5f),
 		_fillShape(true),
 		_distanceFunction(CHEBYSHEV),
+		_downsamplingType(CONSERVATIVE),
 		_gridSubdivisions(256),
 		_launchGPU(true),
 		_marchingCubesSubdivisions(1),
 		_mergeSeedsDistanceFunction(EUCLIDEAN),
+		_meshingChunkSize(32),
+		_meshingType(MARCHING_CUBES_GPU),
 		_metricVoxelization(false),
 		_neighbourhoodType(VON_NEUMANN),
 		_numExtraSeeds(30),
 		_numSeeds(8),
 		_numTriangleSamples(10000),
+		_outOfCoreGrid(false),
 		_pointCloudSeedingRandom(STD_UNIFORM),
 		_removeIsolatedRegions(true),
 		_seed(80),
 		_seedingRandom(HALTON),
 		_spreading(5),
 		_targetTriangles({ 500, 1000 }),
+		_voxelizationCacheFolder(""),
+		_voxelizationType(TETRAVOXELIZER_GPU),
 		_voxelPerMetricUnit(90),
 
 		_renderGrid(true),
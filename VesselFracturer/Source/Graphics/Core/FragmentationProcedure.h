@@ -20,6 +20,7 @@ struct FragmentationProcedure
 	std::string			_saveExtension = ".stl";
 	bool				_saveScreenshots = false;
 	std::string			_searchExtension = ".stl";
+	std::vector<int>	_voxelPerMetricUnits;		//!< Resolutions instantiated from a single voxelization, or only _voxelPerMetricUnit if empty
 
 	struct FragmentMetadata
 	{
@@ -350,7 +350,6 @@ MarchingCubes::MarchingCubes(RegularGrid& regularGrid, unsigned subdivisions, co
 	_faceSSBO = ComputeShader::setWriteBuffer(uvec4(), maxNumPoints / 3, GL_DYNAMIC_DRAW);
 
 	_laplacianSSBO = ComputeShader::setWriteBuffer(ivec4(), maxNumPoints, GL_DYNAMIC_DRAW);
-	_gridSSBO = ComputeShader::setWriteBuffer(uint16_t(), _numDivs.x * _numDivs.y * _numDivs.z, GL_STATIC_DRAW);
 }
 
 MarchingCubes::~MarchingCubes()
@@ -382,9 +381,10 @@ AssimpModel* MarchingCubes::triangulateFieldGPU(GLuint gridSSBO, uint16_t target
 
 				this->resetCounter(_numVerticesSSBO);
 
-				_marchingCubesShader->bindBuffers(std::vector<GLuint>{ _gridSSBO, _verticesSSBO, _numVerticesSSBO, _triangleTableSSBO, _edgeTableSSBO, _supportVerticesSSBO });
+				_marchingCubesShader->bindBuffers(std::vector<GLuint>{ gridSSBO, _verticesSSBO, _numVerticesSSBO, _triangleTableSSBO, _edgeTableSSBO, _supportVerticesSSBO });
 				_marchingCubesShader->use();
-				_marchingCubesShader->setUniform("gridDims", _numDivs);
+				_marchingCubesShader->setUniform("gridDims", _numDivs - uvec3(2));
+				_marchingCubesShader->setUniform("paddedDims", _numDivs);
 				_marchingCubesShader->setUniform("isolevel", 0.5f);
 				_marchingCubesShader->setUniform("localSize", size);
 				_marchingCubesShader->setUniform("start", start);
@@ -546,25 +546,6 @@ void MarchingCubes::smoothSurface(unsigned numVertices, unsigned numFaces, unsig
 	}
 }
 
-void MarchingCubes::setGrid(RegularGrid& regularGrid)
-{
-	uint16_t* gridData = (uint16_t*)malloc(sizeof(float) * _numDivs.x * _numDivs.y * _numDivs.z);
-#pragma omp parallel for
-	for (int x = 0; x < _numDivs.x; ++x)
-		for (int y = 0; y < _numDivs.y; ++y)
-			for (int z = 0; z < _numDivs.z; ++z)
-				gridData[x * _numDivs.y * _numDivs.z + y * _numDivs.z + z] = VOXEL_FREE;
-
-#pragma omp parallel for
-	for (int x = 1; x < _numDivs.x - 1; ++x)
-		for (int y = 1; y < _numDivs.y - 1; ++y)
-			for (int z = 1; z < _numDivs.z - 1; ++z)
-				gridData[x * _numDivs.y * _numDivs.z + y * _numDivs.z + z] = regularGrid.at(x - 1, y - 1, z - 1);
-
-	ComputeShader::updateReadBufferSubset(_gridSSBO, gridData, 0, _numDivs.x * _numDivs.y * _numDivs.z);
-	free(gridData);
-}
-
 void MarchingCubes::sortMortonCodes(unsigned numVertices)
 {
 	const unsigned numBits = 30;	// 10 bits per coordinate (3D)
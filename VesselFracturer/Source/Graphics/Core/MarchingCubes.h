@@ -5,6 +5,8 @@
 
 class MarchingCubes
 {
+	friend class MarchingCubesCPU;
+
 protected:
 	static const int _triangleTable[256 * 16];
 	static const int _edgeTable[256];
@@ -36,7 +38,6 @@ protected:
 
 	// SSBOs
 	GLuint          _edgeTableSSBO;
-	GLuint          _gridSSBO;
 	GLuint          _mortonCodeSSBO;
 	GLuint          _nonUpdatedVerticesSSBO;
 	GLuint          _numVerticesSSBO;
@@ -103,12 +104,8 @@ public:
 	virtual ~MarchingCubes();
 
 	/**
-	*   @brief Modifies the content related to the grid.
-	*/
-	void setGrid(RegularGrid& regularGrid);
-
-	/**
-	*   @brief Triangulate a scalar field represented by `scalarFunction`. `isovalue` should be used for isovalue computation.
+	*   @brief Triangulate a scalar field represented by `scalarFunction`. `isovalue` should be used for isovalue computation. The grid 
+	*   SSBO is read as is, with a virtual border of free voxels.
 	*/
 	AssimpModel* triangulateFieldGPU(GLuint gridSSBO, uint16_t targetValue, FractureParameters& fractureParams, const mat4& modelMatrix);
 };
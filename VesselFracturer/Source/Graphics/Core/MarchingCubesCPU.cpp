@@ -0,0 +1,491 @@
+#include "stdafx.h"
+#include "MarchingCubesCPU.h"
+
+#include "Graphics/Core/MarchingCubes.h"
+#include "Graphics/Core/MeshSink.h"
+
+// [Static attributes]
+
+const float MarchingCubesCPU::BOUNDARY_WEIGHT = .08f;
+const float MarchingCubesCPU::CONVERGENCE_THRESHOLD = 1e-3f;
+const float MarchingCubesCPU::TAUBIN_LAMBDA = .5f;
+const float MarchingCubesCPU::TAUBIN_MU = -.53f;
+
+const ivec3 MarchingCubesCPU::NEIGHBOURS[8] = {
+	ivec3(0, 0, 0), ivec3(0, 0, 1), ivec3(-1, 0, 1), ivec3(-1, 0, 0),
+	ivec3(0, 1, 0), ivec3(0, 1, 1), ivec3(-1, 1, 1), ivec3(-1, 1, 0)
+};
+
+const ivec2 MarchingCubesCPU::EDGES[12] = {
+	ivec2(0, 1), ivec2(1, 2), ivec2(2, 3), ivec2(3, 0),
+	ivec2(4, 5), ivec2(5, 6), ivec2(6, 7), ivec2(7, 4),
+	ivec2(0, 4), ivec2(1, 5), ivec2(2, 6), ivec2(3, 7)
+};
+
+// [Public methods]
+
+MarchingCubesCPU::MarchingCubesCPU(const uvec3& numDivs) : _numDivs(numDivs + uvec3(2))
+{
+}
+
+MarchingCubesCPU::~MarchingCubesCPU()
+{
+}
+
+std::vector<AssimpModel*> MarchingCubesCPU::triangulateFields(const PaddedGridView& grid, const std::vector<uint16_t>& values, FractureParameters& fractureParams, const mat4& modelMatrix)
+{
+	std::vector<LabelMesh> meshes(values.size());
+	this->meshFields(grid, values, fractureParams, modelMatrix, [&meshes](unsigned meshIdx, LabelMesh& mesh) { meshes[meshIdx] = std::move(mesh); });
+
+	return this->createModels(meshes, fractureParams);
+}
+
+bool MarchingCubesCPU::triangulateFields(const PaddedGridView& grid, const std::vector<uint16_t>& values, FractureParameters& fractureParams, const mat4& modelMatrix, const std::vector<MeshSink*>& sinks)
+{
+	std::vector<char> success(values.size(), false);
+	this->meshFields(grid, values, fractureParams, modelMatrix, [this, &sinks, &success](unsigned meshIdx, LabelMesh& mesh) { success[meshIdx] = this->writeMesh(mesh, sinks[meshIdx]); });
+
+	return std::all_of(success.begin(), success.end(), [](char meshSuccess) { return meshSuccess; });
+}
+
+std::vector<AssimpModel*> MarchingCubesCPU::triangulateActiveCells(const PaddedGridView& grid, const std::vector<RegularGrid::FragmentSurface>& fragments, FractureParameters& fractureParams, const mat4& modelMatrix)
+{
+	std::vector<LabelMesh> meshes(fragments.size());
+	this->meshActiveCells(grid, fragments, modelMatrix, [&meshes](unsigned meshIdx, LabelMesh& mesh) { meshes[meshIdx] = std::move(mesh); });
+
+	return this->createModels(meshes, fractureParams);
+}
+
+bool MarchingCubesCPU::triangulateActiveCells(const PaddedGridView& grid, const std::vector<RegularGrid::FragmentSurface>& fragments, const mat4& modelMatrix, const std::vector<MeshSink*>& sinks)
+{
+	std::vector<char> success(fragments.size(), false);
+	this->meshActiveCells(grid, fragments, modelMatrix, [this, &sinks, &success](unsigned meshIdx, LabelMesh& mesh) { success[meshIdx] = this->writeMesh(mesh, sinks[meshIdx]); });
+
+	return std::all_of(success.begin(), success.end(), [](char meshSuccess) { return meshSuccess; });
+}
+
+// [Protected methods]
+
+void MarchingCubesCPU::buildAdjacency(const LabelMesh& mesh, std::vector<unsigned>& offsets, std::vector<unsigned>& neighbours) const
+{
+	const int numVertices = int(mesh._vertices.size());
+
+	// Every face adds its two other vertices to the row of each corner; duplicates are removed afterwards
+	std::vector<unsigned> rowSize(numVertices, 0), rawOffsets(numVertices + 1, 0);
+	for (const uvec4& face : mesh._faces)
+		for (int i = 0; i < 3; ++i)
+			rowSize[face[i]] += 2;
+
+	for (int vertexIdx = 0; vertexIdx < numVertices; ++vertexIdx)
+		rawOffsets[vertexIdx + 1] = rawOffsets[vertexIdx] + rowSize[vertexIdx];
+
+	std::vector<unsigned> rawNeighbours(rawOffsets.back()), cursor(rawOffsets.begin(), rawOffsets.end() - 1);
+	for (const uvec4& face : mesh._faces)
+	{
+		for (int i = 0; i < 3; ++i)
+		{
+			rawNeighbours[cursor[face[i]]++] = face[(i + 1) % 3];
+			rawNeighbours[cursor[face[i]]++] = face[(i + 2) % 3];
+		}
+	}
+
+#pragma omp parallel for
+	for (int vertexIdx = 0; vertexIdx < numVertices; ++vertexIdx)
+	{
+		auto first = rawNeighbours.begin() + rawOffsets[vertexIdx], last = rawNeighbours.begin() + rawOffsets[vertexIdx + 1];
+		std::sort(first, last);
+		rowSize[vertexIdx] = unsigned(std::unique(first, last) - first);
+	}
+
+	offsets.resize(numVertices + 1);
+	offsets[0] = 0;
+	for (int vertexIdx = 0; vertexIdx < numVertices; ++vertexIdx)
+		offsets[vertexIdx + 1] = offsets[vertexIdx] + rowSize[vertexIdx];
+
+	neighbours.resize(offsets.back());
+
+#pragma omp parallel for
+	for (int vertexIdx = 0; vertexIdx < numVertices; ++vertexIdx)
+		std::copy(rawNeighbours.begin() + rawOffsets[vertexIdx], rawNeighbours.begin() + rawOffsets[vertexIdx] + rowSize[vertexIdx], neighbours.begin() + offsets[vertexIdx]);
+}
+
+std::vector<AssimpModel*> MarchingCubesCPU::createModels(std::vector<LabelMesh>& meshes, FractureParameters& fractureParams) const
+{
+	std::vector<AssimpModel*> models(meshes.size());
+
+	for (int meshIdx = 0; meshIdx < meshes.size(); ++meshIdx)
+	{
+		models[meshIdx] = new AssimpModel();
+		if (!meshes[meshIdx]._faces.empty())
+			models[meshIdx]->insert(meshes[meshIdx]._vertices.data(), meshes[meshIdx]._vertices.size(), meshes[meshIdx]._faces.data(), meshes[meshIdx]._faces.size());
+		models[meshIdx]->endInsertionBatch(false, fractureParams._renderMesh);
+
+		meshes[meshIdx] = LabelMesh();
+	}
+
+	return models;
+}
+
+uint64_t MarchingCubesCPU::getEdgeKey(const ivec3& corner1, const ivec3& corner2) const
+{
+	// Midpoints lie on a lattice of half a voxel
+	const glm::u64vec3 doubled = glm::u64vec3(corner1 + corner2);
+	return (doubled.x * (2 * _numDivs.y) + doubled.y) * (2 * _numDivs.z) + doubled.z;
+}
+
+void MarchingCubesCPU::march(const PaddedGridView& grid, const std::vector<int>& labelSlot, const Chunk& chunk, std::vector<ChunkMesh>& meshes) const
+{
+	const uint16_t boundaryMask = uint16_t(1 << 15);
+	uint16_t labels[8], cellLabels[8];
+
+	// Corners of the chunk range from (first.x - 1, first.y, first.z) to (last.x - 1, last.y, last.z)
+	const ivec3 firstCorner = ivec3(chunk._first) - ivec3(1, 0, 0), lastCorner = ivec3(chunk._last) - ivec3(1, 0, 0);
+	const unsigned width = chunk._last.z - chunk._first.z + 1;
+
+	// Cells of layer x have their corners in planes x - 1 and x
+	EdgeCache previousPlane, currentPlane;
+	previousPlane._slots.resize(size_t(chunk._last.y - chunk._first.y + 1) * width * 3);
+	currentPlane._slots.resize(previousPlane._slots.size());
+	previousPlane.clear();
+
+	for (unsigned x = chunk._first.x; x < chunk._last.x; ++x)
+	{
+		currentPlane.clear();
+
+		for (unsigned y = chunk._first.y; y < chunk._last.y; ++y)
+		{
+			for (unsigned z = chunk._first.z; z < chunk._last.z; ++z)
+			{
+				const ivec3 cell = ivec3(x, y, z);
+				bool uniform = true;
+
+				for (int cornerIdx = 0; cornerIdx < 8; ++cornerIdx)
+				{
+					const ivec3 corner = cell + NEIGHBOURS[cornerIdx];
+					labels[cornerIdx] = grid.at(corner.x, corner.y, corner.z) & ~boundaryMask;
+					uniform &= labels[cornerIdx] == labels[0];
+				}
+
+				if (uniform) continue;
+
+				// Distinct labels of this cell, each one is triangulated as the isosurface of its own indicator function
+				unsigned numCellLabels = 0;
+				for (int cornerIdx = 0; cornerIdx < 8; ++cornerIdx)
+				{
+					const uint16_t label = labels[cornerIdx];
+					if (label >= labelSlot.size() || labelSlot[label] < 0 || std::find(cellLabels, cellLabels + numCellLabels, label) != cellLabels + numCellLabels)
+						continue;
+
+					cellLabels[numCellLabels++] = label;
+				}
+
+				const unsigned isBoundary = numCellLabels ? unsigned((grid.at(x, y, z) & boundaryMask) != 0) : 0;
+
+				for (unsigned labelIdx = 0; labelIdx < numCellLabels; ++labelIdx)
+				{
+					int configuration = 0;
+					for (int cornerIdx = 0; cornerIdx < 8; ++cornerIdx)
+						configuration |= int(labels[cornerIdx] != cellLabels[labelIdx]) << cornerIdx;
+
+					ChunkMesh& mesh = meshes[labelSlot[cellLabels[labelIdx]]];
+					const int* triangles = &MarchingCubes::_triangleTable[configuration * 16];
+
+					for (int triangleIdx = 0; triangleIdx < 5 && triangles[triangleIdx * 3] != -1; ++triangleIdx)
+					{
+						uvec4 face = uvec4(0, 0, 0, isBoundary);
+						int faceVertexIdx = 0;
+
+						for (int vertexIdx : { 0, 2, 1 })
+						{
+							// Edges are identified by their lower corner and axis; the slot depends on which endpoint belongs to the label
+							const ivec2 edge = EDGES[triangles[triangleIdx * 3 + vertexIdx]];
+							const ivec3 corner1 = cell + NEIGHBOURS[edge.x], corner2 = cell + NEIGHBOURS[edge.y];
+							const unsigned axis = corner1.x != corner2.x ? 0 : (corner1.y != corner2.y ? 1 : 2);
+							const bool firstIsLower = corner1[axis] < corner2[axis];
+							const ivec3 lowerCorner = firstIsLower ? corner1 : corner2;
+							const int slot = int(labels[firstIsLower ? edge.x : edge.y] != cellLabels[labelIdx]);
+
+							EdgeCache& plane = lowerCorner.x == int(x) - 1 ? previousPlane : currentPlane;
+							int& vertexSlot = plane.at(lowerCorner.y - firstCorner.y, lowerCorner.z - firstCorner.z, axis, width)[slot];
+
+							if (vertexSlot < 0)
+							{
+								vec3 position = vec3(lowerCorner);
+								position[axis] += .5f;
+
+								vertexSlot = int(mesh._vertices.size());
+								mesh._vertices.push_back(vec4(position, .0f));
+
+								// Edges lying on the faces of the chunk are shared with the neighbour chunks
+								bool isSeam = false;
+								for (unsigned faceAxis = 0; faceAxis < 3; ++faceAxis)
+									isSeam |= faceAxis != axis && (lowerCorner[faceAxis] == firstCorner[faceAxis] || lowerCorner[faceAxis] == lastCorner[faceAxis]);
+
+								if (isSeam)
+									mesh._seamVertices.push_back(std::make_pair(this->getEdgeKey(corner1, corner2), unsigned(vertexSlot)));
+							}
+
+							face[faceVertexIdx++] = unsigned(vertexSlot);
+						}
+
+						mesh._faces.push_back(face);
+					}
+				}
+			}
+		}
+
+		std::swap(previousPlane, currentPlane);
+	}
+}
+
+void MarchingCubesCPU::marchActiveCells(const PaddedGridView& grid, uint16_t label, const std::vector<uint64_t>& activeCells, ChunkMesh& mesh) const
+{
+	const uint16_t boundaryMask = uint16_t(1 << 15);
+	const uint64_t sliceSize = uint64_t(_numDivs.y) * _numDivs.z;
+	uint16_t labels[8];
+
+	// Roughly two vertices per active cell, as in a closed surface
+	std::unordered_map<uint64_t, unsigned> edgeVertices;
+	edgeVertices.reserve(activeCells.size() * 2);
+
+	for (const uint64_t cellKey : activeCells)
+	{
+		const ivec3 cell = ivec3(int(cellKey / sliceSize), int(cellKey % sliceSize / _numDivs.z), int(cellKey % _numDivs.z));
+
+		int configuration = 0;
+		for (int cornerIdx = 0; cornerIdx < 8; ++cornerIdx)
+		{
+			const ivec3 corner = cell + NEIGHBOURS[cornerIdx];
+			labels[cornerIdx] = grid.at(corner.x, corner.y, corner.z) & ~boundaryMask;
+			configuration |= int(labels[cornerIdx] != label) << cornerIdx;
+		}
+
+		if (configuration == 0 || configuration == 255) continue;
+
+		const unsigned isBoundary = unsigned((grid.at(cell.x, cell.y, cell.z) & boundaryMask) != 0);
+		const int* triangles = &MarchingCubes::_triangleTable[configuration * 16];
+
+		for (int triangleIdx = 0; triangleIdx < 5 && triangles[triangleIdx * 3] != -1; ++triangleIdx)
+		{
+			uvec4 face = uvec4(0, 0, 0, isBoundary);
+			int faceVertexIdx = 0;
+
+			for (int vertexIdx : { 0, 2, 1 })
+			{
+				const ivec2 edge = EDGES[triangles[triangleIdx * 3 + vertexIdx]];
+				const ivec3 corner1 = cell + NEIGHBOURS[edge.x], corner2 = cell + NEIGHBOURS[edge.y];
+				auto [it, inserted] = edgeVertices.try_emplace(this->getEdgeKey(corner1, corner2), unsigned(mesh._vertices.size()));
+
+				if (inserted)
+					mesh._vertices.push_back(vec4((vec3(corner1) + vec3(corner2)) * .5f, .0f));
+
+				face[faceVertexIdx++] = it->second;
+			}
+
+			mesh._faces.push_back(face);
+		}
+	}
+}
+
+void MarchingCubesCPU::meshActiveCells(const PaddedGridView& grid, const std::vector<RegularGrid::FragmentSurface>& fragments, const mat4& modelMatrix, const std::function<void(unsigned, LabelMesh&)>& emitMesh) const
+{
+#pragma omp parallel for schedule(dynamic)
+	for (int fragmentIdx = 0; fragmentIdx < fragments.size(); ++fragmentIdx)
+	{
+		// A single chunk without seams, stitching only transforms the vertices and propagates the boundary flags
+		std::vector<ChunkMesh> labelChunks(1);
+		LabelMesh mesh;
+
+		this->marchActiveCells(grid, fragments[fragmentIdx]._value, fragments[fragmentIdx]._activeCells, labelChunks[0]);
+		this->stitchChunks(labelChunks, modelMatrix, mesh);
+		this->smoothSurface(mesh);
+
+		emitMesh(fragmentIdx, mesh);
+	}
+}
+
+void MarchingCubesCPU::meshFields(const PaddedGridView& grid, const std::vector<uint16_t>& values, FractureParameters& fractureParams, const mat4& modelMatrix, const std::function<void(unsigned, LabelMesh&)>& emitMesh) const
+{
+	if (values.empty()) return;
+
+	// Labels which are not requested are skipped within the sweep
+	std::vector<int> labelSlot(*std::max_element(values.begin(), values.end()) + 1, -1);
+	for (int valueIdx = 0; valueIdx < values.size(); ++valueIdx)
+		labelSlot[values[valueIdx]] = valueIdx;
+
+	// Cells are given by their (+x, -y, -z) corner, from (1, 0, 0) to _numDivs - (0, 1, 1)
+	const uvec3 firstCell = uvec3(1, 0, 0), lastCell = _numDivs - uvec3(0, 1, 1);
+	const unsigned chunkSize = unsigned(std::max(fractureParams._meshingChunkSize, 1));
+	const uvec3 numChunks = (lastCell - firstCell + chunkSize - 1u) / chunkSize;
+	std::vector<Chunk> chunks;
+
+	for (unsigned x = 0; x < numChunks.x; ++x)
+		for (unsigned y = 0; y < numChunks.y; ++y)
+			for (unsigned z = 0; z < numChunks.z; ++z)
+			{
+				const uvec3 first = firstCell + uvec3(x, y, z) * chunkSize;
+				chunks.push_back(Chunk{ first, glm::min(first + chunkSize, lastCell) });
+			}
+
+	std::vector<std::vector<ChunkMesh>> chunkMeshes(chunks.size(), std::vector<ChunkMesh>(values.size()));
+
+#pragma omp parallel for schedule(dynamic)
+	for (int chunkIdx = 0; chunkIdx < chunks.size(); ++chunkIdx)
+		this->march(grid, labelSlot, chunks[chunkIdx], chunkMeshes[chunkIdx]);
+
+#pragma omp parallel for schedule(dynamic)
+	for (int valueIdx = 0; valueIdx < values.size(); ++valueIdx)
+	{
+		std::vector<ChunkMesh> labelChunks(chunks.size());
+		LabelMesh mesh;
+
+		for (unsigned chunkIdx = 0; chunkIdx < chunks.size(); ++chunkIdx)
+			labelChunks[chunkIdx] = std::move(chunkMeshes[chunkIdx][valueIdx]);
+
+		this->stitchChunks(labelChunks, modelMatrix, mesh);
+		this->smoothSurface(mesh);
+
+		emitMesh(valueIdx, mesh);
+	}
+}
+
+void MarchingCubesCPU::smoothSurface(LabelMesh& mesh) const
+{
+	const int numVertices = int(mesh._vertices.size());
+	if (numVertices == 0) return;
+
+	std::vector<unsigned> offsets, neighbours;
+	this->buildAdjacency(mesh, offsets, neighbours);
+
+	std::vector<vec3> positions(numVertices), smoothedPositions(numVertices);
+	std::vector<float> boundary(numVertices);
+
+	for (int vertexIdx = 0; vertexIdx < numVertices; ++vertexIdx)
+	{
+		positions[vertexIdx] = vec3(mesh._vertices[vertexIdx]);
+		boundary[vertexIdx] = mesh._vertices[vertexIdx].w;
+	}
+
+	// Displacements are measured against the mean edge length
+	double edgeLength = .0;
+
+#pragma omp parallel for reduction(+: edgeLength)
+	for (int vertexIdx = 0; vertexIdx < numVertices; ++vertexIdx)
+		for (unsigned neighbourIdx = offsets[vertexIdx]; neighbourIdx < offsets[vertexIdx + 1]; ++neighbourIdx)
+			edgeLength += glm::distance(positions[vertexIdx], positions[neighbours[neighbourIdx]]);
+
+	const double threshold = CONVERGENCE_THRESHOLD * edgeLength / std::max(size_t(1), neighbours.size());
+
+	for (unsigned iteration = 0; iteration < SMOOTHING_ITERATIONS; ++iteration)
+	{
+		const float boundaryWeight = iteration >= BOUNDARY_ITERATIONS ? BOUNDARY_WEIGHT : .0f;
+		double displacement = .0;
+
+		for (float factor : { TAUBIN_LAMBDA, TAUBIN_MU })
+		{
+#pragma omp parallel for reduction(+: displacement)
+			for (int vertexIdx = 0; vertexIdx < numVertices; ++vertexIdx)
+			{
+				const unsigned firstNeighbour = offsets[vertexIdx], lastNeighbour = offsets[vertexIdx + 1];
+				if (firstNeighbour == lastNeighbour)
+				{
+					smoothedPositions[vertexIdx] = positions[vertexIdx];
+					continue;
+				}
+
+				vec3 average = vec3(.0f);
+				for (unsigned neighbourIdx = firstNeighbour; neighbourIdx < lastNeighbour; ++neighbourIdx)
+					average += positions[neighbours[neighbourIdx]];
+				average /= float(lastNeighbour - firstNeighbour);
+
+				const vec3 offset = (boundary[vertexIdx] == 1.0f ? boundaryWeight : 1.0f) * factor * (average - positions[vertexIdx]);
+				smoothedPositions[vertexIdx] = positions[vertexIdx] + offset;
+				displacement += glm::dot(offset, offset);
+			}
+
+			std::swap(positions, smoothedPositions);
+		}
+
+		if (iteration >= BOUNDARY_ITERATIONS && std::sqrt(displacement / (2.0 * numVertices)) < threshold)
+			break;
+	}
+
+	for (int vertexIdx = 0; vertexIdx < numVertices; ++vertexIdx)
+		mesh._vertices[vertexIdx] = vec4(positions[vertexIdx], boundary[vertexIdx]);
+}
+
+void MarchingCubesCPU::stitchChunks(std::vector<ChunkMesh>& chunks, const mat4& modelMatrix, LabelMesh& mesh) const
+{
+	// Seam vertices are sorted by grid key and chunk, so that the first occurrence of each key owns the vertex
+	std::vector<std::tuple<uint64_t, unsigned, unsigned>> seamVertices;
+	for (unsigned chunkIdx = 0; chunkIdx < chunks.size(); ++chunkIdx)
+		for (const auto& seamVertex : chunks[chunkIdx]._seamVertices)
+			seamVertices.push_back(std::make_tuple(seamVertex.first, chunkIdx, seamVertex.second));
+	std::sort(seamVertices.begin(), seamVertices.end());
+
+	std::vector<std::vector<unsigned>> remap(chunks.size());
+	for (unsigned chunkIdx = 0; chunkIdx < chunks.size(); ++chunkIdx)
+		remap[chunkIdx].resize(chunks[chunkIdx]._vertices.size(), 0);
+
+	const unsigned duplicate = std::numeric_limits<unsigned>::max();
+	for (size_t seamIdx = 1; seamIdx < seamVertices.size(); ++seamIdx)
+		if (std::get<0>(seamVertices[seamIdx]) == std::get<0>(seamVertices[seamIdx - 1]))
+			remap[std::get<1>(seamVertices[seamIdx])][std::get<2>(seamVertices[seamIdx])] = duplicate;
+
+	size_t numVertices = 0, numFaces = 0;
+	for (unsigned chunkIdx = 0; chunkIdx < chunks.size(); ++chunkIdx)
+	{
+		for (unsigned& vertexIdx : remap[chunkIdx])
+			if (vertexIdx != duplicate) vertexIdx = unsigned(numVertices++);
+		numFaces += chunks[chunkIdx]._faces.size();
+	}
+
+	for (size_t seamIdx = 1; seamIdx < seamVertices.size(); ++seamIdx)
+	{
+		auto& [key, chunkIdx, vertexIdx] = seamVertices[seamIdx];
+		if (key == std::get<0>(seamVertices[seamIdx - 1]))
+			remap[chunkIdx][vertexIdx] = remap[std::get<1>(seamVertices[seamIdx - 1])][std::get<2>(seamVertices[seamIdx - 1])];
+	}
+
+	mesh._vertices.resize(numVertices);
+	mesh._faces.resize(numFaces);
+
+	for (unsigned chunkIdx = 0; chunkIdx < chunks.size(); ++chunkIdx)
+		for (unsigned vertexIdx = 0; vertexIdx < chunks[chunkIdx]._vertices.size(); ++vertexIdx)
+			mesh._vertices[remap[chunkIdx][vertexIdx]] = vec4(vec3(modelMatrix * vec4(vec3(chunks[chunkIdx]._vertices[vertexIdx]), 1.0f)), .0f);
+
+	size_t faceOffset = 0;
+	for (unsigned chunkIdx = 0; chunkIdx < chunks.size(); ++chunkIdx)
+	{
+		for (const uvec4& face : chunks[chunkIdx]._faces)
+		{
+			uvec4& newFace = mesh._faces[faceOffset++];
+			for (int i = 0; i < 3; ++i)
+			{
+				newFace[i] = remap[chunkIdx][face[i]];
+				mesh._vertices[newFace[i]].w = std::max(mesh._vertices[newFace[i]].w, float(face.w));
+			}
+		}
+
+		chunks[chunkIdx] = ChunkMesh();
+	}
+
+	for (uvec4& face : mesh._faces)
+		face.w = unsigned(std::max(mesh._vertices[face.x].w, std::max(mesh._vertices[face.y].w, mesh._vertices[face.z].w)));
+}
+
+bool MarchingCubesCPU::writeMesh(LabelMesh& mesh, MeshSink* sink) const
+{
+	bool success = sink && sink->begin(mesh._vertices.size(), mesh._faces.size());
+
+	if (success)
+	{
+		sink->writeVertices(mesh._vertices.data(), mesh._vertices.size());
+		sink->writeFaces(mesh._faces.data(), mesh._faces.size());
+		success = sink->end();
+	}
+
+	mesh = LabelMesh();
+
+	return success;
+}
@@ -0,0 +1,158 @@
+#pragma once
+
+#include "DataStructures/PaddedGridView.h"
+#include "DataStructures/RegularGrid.h"
+#include "Graphics/Core/AssimpModel.h"
+
+class MeshSink;
+
+/**
+*	@file MarchingCubesCPU.h
+*	@authors Alfonso Lpez Ruiz (alr00048@red.ujaen.es)
+*	@date 19/10/2026
+*/
+
+/**
+*	@brief Multi-label marching cubes on the CPU. Each cell of the grid is visited once and triangulated for every fragment label found 
+*	at its corners, so that meshing all the fragments costs a single sweep. The grid is split into chunks which are processed in parallel 
+*	with their own per-label buffers, and then concatenated in chunk order to keep the output deterministic. Every grid edge owns a single 
+*	vertex per label, which is shared through per-chunk edge caches, hence no sorting or fusion of vertices is needed. Vertices on the 
+*	faces of chunks are welded by grid key, so the chunk size only affects performance.
+*/
+class MarchingCubesCPU
+{
+protected:
+	struct LabelMesh
+	{
+		std::vector<vec4>		_vertices;
+		std::vector<uvec4>		_faces;
+	};
+
+	struct ChunkMesh : public LabelMesh
+	{
+		std::vector<std::pair<uint64_t, unsigned>> _seamVertices;	//!< Grid key and local index of vertices shared with neighbour chunks
+	};
+
+	/**
+	*	@brief Range of cells [first, last), indexed by their (+x, -y, -z) corner.
+	*/
+	struct Chunk
+	{
+		uvec3					_first, _last;
+	};
+
+	/**
+	*	@brief Vertex slots of the edges whose lower corner lies in a yz-plane of a chunk. Each edge may hold a vertex for the label of either endpoint.
+	*/
+	struct EdgeCache
+	{
+		std::vector<ivec2>		_slots;
+
+		void clear() { std::fill(_slots.begin(), _slots.end(), ivec2(-1)); }
+		ivec2& at(unsigned y, unsigned z, unsigned axis, unsigned width) { return _slots[(y * width + z) * 3 + axis]; }
+	};
+
+protected:
+	static const unsigned		BOUNDARY_ITERATIONS = 3;	//!< Smoothing iterations where boundary vertices remain fixed
+	static const float			BOUNDARY_WEIGHT;			//!< Damping of the smoothing on boundary vertices
+	static const float			CONVERGENCE_THRESHOLD;		//!< Smoothing stops once the RMS displacement falls below this fraction of the mean edge length
+	static const unsigned		SMOOTHING_ITERATIONS = 10;	//!< Maximum number of Taubin iterations (lambda and mu passes)
+	static const float			TAUBIN_LAMBDA;				//!< Shrinking factor of Taubin smoothing
+	static const float			TAUBIN_MU;					//!< Inflating factor of Taubin smoothing
+
+	static const ivec3			NEIGHBOURS[8];			//!< Corners of a cell
+	static const ivec2			EDGES[12];				//!< Corners of each cell edge
+
+protected:
+	uvec3						_numDivs;				//!< Dimensions of the grid, including a virtual border of one voxel
+
+protected:
+	/**
+	*	@return Key of the midpoint of an edge given by two corners, unique within the grid.
+	*/
+	uint64_t getEdgeKey(const ivec3& corner1, const ivec3& corner2) const;
+
+	/**
+	*	@brief Triangulates the cells of a chunk for every label with a slot.
+	*/
+	virtual void march(const PaddedGridView& grid, const std::vector<int>& labelSlot, const Chunk& chunk, std::vector<ChunkMesh>& meshes) const;
+
+	/**
+	*	@brief Triangulates a single label within its active cells, vertices are shared through a map keyed by the edge midpoint.
+	*/
+	void marchActiveCells(const PaddedGridView& grid, uint16_t label, const std::vector<uint64_t>& activeCells, ChunkMesh& mesh) const;
+
+	/**
+	*	@brief Meshes every fragment within its active cells. Each mesh is handed to the callback as soon as it is smoothed, from the thread which built it.
+	*/
+	void meshActiveCells(const PaddedGridView& grid, const std::vector<RegularGrid::FragmentSurface>& fragments, const mat4& modelMatrix, const std::function<void(unsigned, LabelMesh&)>& emitMesh) const;
+
+	/**
+	*	@brief Meshes every label in a single sweep. Each mesh is handed to the callback as soon as it is smoothed, from the thread which built it.
+	*/
+	void meshFields(const PaddedGridView& grid, const std::vector<uint16_t>& values, FractureParameters& fractureParams, const mat4& modelMatrix, const std::function<void(unsigned, LabelMesh&)>& emitMesh) const;
+
+	/**
+	*	@brief Builds the vertex adjacency of a mesh in compressed sparse row format.
+	*/
+	void buildAdjacency(const LabelMesh& mesh, std::vector<unsigned>& offsets, std::vector<unsigned>& neighbours) const;
+
+	/**
+	*	@brief Moves the meshes into models, which are created sequentially.
+	*/
+	std::vector<AssimpModel*> createModels(std::vector<LabelMesh>& meshes, FractureParameters& fractureParams) const;
+
+	/**
+	*	@brief Taubin smoothing of a welded mesh, boundary vertices are kept during the first iterations. Each pass gathers the neighbours 
+	*	of every vertex from the CSR adjacency, hence vertices are updated independently.
+	*/
+	void smoothSurface(LabelMesh& mesh) const;
+
+	/**
+	*	@brief Concatenates the meshes of every chunk, welding the vertices of their shared faces by grid key, and transforms the vertices into world space.
+	*/
+	void stitchChunks(std::vector<ChunkMesh>& chunks, const mat4& modelMatrix, LabelMesh& mesh) const;
+
+	/**
+	*	@brief Streams a mesh into a sink and releases it.
+	*	@return False if the sink is missing or failed.
+	*/
+	bool writeMesh(LabelMesh& mesh, MeshSink* sink) const;
+
+public:
+	/**
+	*	@brief Constructor.
+	*	@param numDivs Dimensions of the regular grid.
+	*/
+	MarchingCubesCPU(const uvec3& numDivs);
+
+	/**
+	*	@brief Destructor.
+	*/
+	virtual ~MarchingCubesCPU();
+
+	/**
+	*	@brief Triangulates every label in a single sweep of the grid.
+	*	@return One model per label, in the same order.
+	*/
+	std::vector<AssimpModel*> triangulateFields(const PaddedGridView& grid, const std::vector<uint16_t>& values, FractureParameters& fractureParams, const mat4& modelMatrix);
+
+	/**
+	*	@brief Triangulates every label in a single sweep, streaming each mesh into its sink instead of building models. Sinks are written concurrently, hence they must be distinct.
+	*	@return True if every mesh was written.
+	*/
+	bool triangulateFields(const PaddedGridView& grid, const std::vector<uint16_t>& values, FractureParameters& fractureParams, const mat4& modelMatrix, const std::vector<MeshSink*>& sinks);
+
+	/**
+	*	@brief Triangulates every fragment visiting only the cells around its surface, so that the cost scales with the surface rather than the volume of the grid.
+	*	@return One model per fragment, in the same order.
+	*/
+	std::vector<AssimpModel*> triangulateActiveCells(const PaddedGridView& grid, const std::vector<RegularGrid::FragmentSurface>& fragments, FractureParameters& fractureParams, const mat4& modelMatrix);
+
+	/**
+	*	@brief Triangulates every fragment within its active cells, streaming each mesh into its sink. Sinks are written concurrently, hence they must be distinct.
+	*	@return True if every mesh was written.
+	*/
+	bool triangulateActiveCells(const PaddedGridView& grid, const std::vector<RegularGrid::FragmentSurface>& fragments, const mat4& modelMatrix, const std::vector<MeshSink*>& sinks);
+};
+
@@ -0,0 +1,296 @@
+#include "stdafx.h"
+#include "MeshCodec.h"
+
+#include <cstring>
+
+// [Static attributes]
+
+const std::string MeshCodec::EXTENSION = ".qmesh";
+
+const char MeshCodec::MAGIC[4] = { 'Q', 'M', 'S', 'H' };
+const unsigned MeshCodec::BLOCK_SIZE = 1 << 14;
+const uint16_t MeshCodec::VERSION = 1;
+
+// [Public methods]
+
+bool MeshCodec::decode(const char* data, size_t size, std::vector<vec3>& positions, std::vector<uvec3>& faces)
+{
+	Header header;
+	if (size < sizeof(Header)) return false;
+
+	std::memcpy(&header, data, sizeof(Header));
+	if (std::memcmp(header._magic, MAGIC, sizeof(MAGIC)) != 0 || header._version != VERSION) return false;
+	if (header._numVertexBlocks != (uint64_t(header._numVertices) + BLOCK_SIZE - 1) / BLOCK_SIZE || header._numFaceBlocks != (uint64_t(header._numFaces) + BLOCK_SIZE - 1) / BLOCK_SIZE) return false;
+
+	// Every vertex and face takes at least three bytes, which bounds the allocations of corrupted files
+	if ((uint64_t(header._numVertices) + header._numFaces) * 3 > size) return false;
+
+	// Offsets of every block, vertices first
+	const int numBlocks = static_cast<int>(header._numVertexBlocks + header._numFaceBlocks);
+	if (size - sizeof(Header) < numBlocks * sizeof(uint32_t)) return false;
+
+	std::vector<uint32_t> blockSize(numBlocks);
+	std::vector<size_t> blockOffset(numBlocks + 1);
+	std::memcpy(blockSize.data(), data + sizeof(Header), numBlocks * sizeof(uint32_t));
+
+	blockOffset[0] = sizeof(Header) + numBlocks * sizeof(uint32_t);
+	for (int blockIdx = 0; blockIdx < numBlocks; ++blockIdx)
+		blockOffset[blockIdx + 1] = blockOffset[blockIdx] + blockSize[blockIdx];
+
+	if (blockOffset[numBlocks] != size) return false;
+
+	positions.resize(header._numVertices);
+	faces.resize(header._numFaces);
+
+	const int numVertexBlocks = static_cast<int>(header._numVertexBlocks);
+	const uint8_t* bytes = reinterpret_cast<const uint8_t*>(data);
+	std::vector<char> blockFailed(numBlocks, false);
+
+#pragma omp parallel for
+	for (int blockIdx = 0; blockIdx < numBlocks; ++blockIdx)
+	{
+		const uint8_t* ptr = bytes + blockOffset[blockIdx];
+		const uint8_t* end = bytes + blockOffset[blockIdx + 1];
+		int64_t value[3];
+
+		if (blockIdx < numVertexBlocks)
+		{
+			const size_t first = size_t(blockIdx) * BLOCK_SIZE, last = std::min<size_t>(first + BLOCK_SIZE, header._numVertices);
+			int64_t point[3] = { 0, 0, 0 };
+
+			for (size_t vertexIdx = first; vertexIdx < last && !blockFailed[blockIdx]; ++vertexIdx)
+			{
+				for (int axis = 0; axis < 3 && !blockFailed[blockIdx]; ++axis)
+				{
+					blockFailed[blockIdx] = !readVarint(ptr, end, value[axis]);
+					point[axis] += value[axis];
+				}
+
+				positions[vertexIdx] = header._origin + vec3(point[0], point[1], point[2]) * header._step;
+			}
+		}
+		else
+		{
+			const size_t first = size_t(blockIdx - numVertexBlocks) * BLOCK_SIZE, last = std::min<size_t>(first + BLOCK_SIZE, header._numFaces);
+			int64_t previous = 0;
+
+			for (size_t faceIdx = first; faceIdx < last && !blockFailed[blockIdx]; ++faceIdx)
+			{
+				blockFailed[blockIdx] = !readVarint(ptr, end, value[0]) || !readVarint(ptr, end, value[1]) || !readVarint(ptr, end, value[2]);
+
+				const int64_t vertex = previous + value[0];
+				const int64_t face[3] = { vertex, vertex + value[1], vertex + value[2] };
+
+				for (int index = 0; index < 3; ++index)
+				{
+					if (face[index] < 0 || face[index] >= int64_t(header._numVertices)) blockFailed[blockIdx] = true;
+					faces[faceIdx][index] = static_cast<unsigned>(face[index]);
+				}
+
+				previous = vertex;
+			}
+		}
+
+		if (ptr != end) blockFailed[blockIdx] = true;
+	}
+
+	return std::find(blockFailed.begin(), blockFailed.end(), true) == blockFailed.end();
+}
+
+void MeshCodec::encode(const std::vector<vec3>& positions, const std::vector<uvec3>& faces, const Quantization& quantization, std::vector<char>& data)
+{
+	const int numVertices = static_cast<int>(positions.size()), numFaces = static_cast<int>(faces.size());
+
+	// Boundaries, for the Morton codes and the default quantization
+	vec3 minPoint(INFINITY), maxPoint(-INFINITY);
+
+#pragma omp parallel
+	{
+		vec3 localMin(INFINITY), localMax(-INFINITY);
+
+#pragma omp for nowait
+		for (int vertexIdx = 0; vertexIdx < numVertices; ++vertexIdx)
+		{
+			localMin = glm::min(localMin, positions[vertexIdx]);
+			localMax = glm::max(localMax, positions[vertexIdx]);
+		}
+
+#pragma omp critical
+		{
+			minPoint = glm::min(minPoint, localMin);
+			maxPoint = glm::max(maxPoint, localMax);
+		}
+	}
+
+	if (numVertices == 0) minPoint = maxPoint = vec3(.0f);
+
+	Quantization grid = quantization;
+	if (glm::any(glm::lessThanEqual(grid._step, vec3(.0f))))
+	{
+		grid._origin = minPoint;
+		grid._step = glm::max((maxPoint - minPoint) / 65535.0f, vec3(std::numeric_limits<float>::min()));
+	}
+
+	// Faces are sorted by the Morton code of their centroid
+	const vec3 extent = glm::max(maxPoint - minPoint, vec3(std::numeric_limits<float>::min()));
+	std::vector<uint64_t> faceKey(numFaces);
+
+	auto spread = [](uint64_t value) {
+		value = (value | value << 16) & 0x030000FF;
+		value = (value | value << 8) & 0x0300F00F;
+		value = (value | value << 4) & 0x030C30C3;
+		value = (value | value << 2) & 0x09249249;
+
+		return value;
+	};
+
+#pragma omp parallel for
+	for (int faceIdx = 0; faceIdx < numFaces; ++faceIdx)
+	{
+		const uvec3& face = faces[faceIdx];
+		const vec3 centroid = (positions[face.x] + positions[face.y] + positions[face.z]) / 3.0f;
+		const uvec3 cell = uvec3(glm::clamp((centroid - minPoint) / extent * 1023.0f, vec3(.0f), vec3(1023.0f)));
+
+		faceKey[faceIdx] = (spread(cell.x) << 2 | spread(cell.y) << 1 | spread(cell.z)) << 32 | uint64_t(faceIdx);
+	}
+
+	std::sort(faceKey.begin(), faceKey.end());
+
+	// Vertices are renumbered by their first use, which also drops the unreferenced ones
+	std::vector<unsigned> newIndex(numVertices, std::numeric_limits<unsigned>::max()), vertexOrder;
+	std::vector<uvec3> sortedFaces(numFaces);
+	vertexOrder.reserve(numVertices);
+
+	for (int faceIdx = 0; faceIdx < numFaces; ++faceIdx)
+	{
+		const uvec3& face = faces[faceKey[faceIdx] & 0xFFFFFFFF];
+
+		for (int index = 0; index < 3; ++index)
+		{
+			if (newIndex[face[index]] == std::numeric_limits<unsigned>::max())
+			{
+				newIndex[face[index]] = static_cast<unsigned>(vertexOrder.size());
+				vertexOrder.push_back(face[index]);
+			}
+
+			sortedFaces[faceIdx][index] = newIndex[face[index]];
+		}
+	}
+
+	faceKey = std::vector<uint64_t>();
+	newIndex = std::vector<unsigned>();
+
+	// Every face starts by its lowest index, keeping its winding
+#pragma omp parallel for
+	for (int faceIdx = 0; faceIdx < numFaces; ++faceIdx)
+	{
+		uvec3& face = sortedFaces[faceIdx];
+		if (face.y < face.x && face.y < face.z) face = uvec3(face.y, face.z, face.x);
+		else if (face.z < face.x && face.z < face.y) face = uvec3(face.z, face.x, face.y);
+	}
+
+	const unsigned numUsedVertices = static_cast<unsigned>(vertexOrder.size());
+	const unsigned numVertexBlocks = (numUsedVertices + BLOCK_SIZE - 1) / BLOCK_SIZE, numFaceBlocks = (unsigned(numFaces) + BLOCK_SIZE - 1) / BLOCK_SIZE;
+	const int numBlocks = static_cast<int>(numVertexBlocks + numFaceBlocks);
+	std::vector<std::vector<char>> blocks(numBlocks);
+
+#pragma omp parallel for
+	for (int blockIdx = 0; blockIdx < numBlocks; ++blockIdx)
+	{
+		std::vector<char>& block = blocks[blockIdx];
+
+		if (blockIdx < static_cast<int>(numVertexBlocks))
+		{
+			const size_t first = size_t(blockIdx) * BLOCK_SIZE, last = std::min<size_t>(first + BLOCK_SIZE, numUsedVertices);
+			glm::i64vec3 previous(0);
+			block.reserve((last - first) * 4);
+
+			for (size_t vertexIdx = first; vertexIdx < last; ++vertexIdx)
+			{
+				const glm::i64vec3 point = glm::i64vec3(glm::round((glm::dvec3(positions[vertexOrder[vertexIdx]]) - glm::dvec3(grid._origin)) / glm::dvec3(grid._step)));
+
+				for (int axis = 0; axis < 3; ++axis)
+					pushVarint(block, point[axis] - previous[axis]);
+
+				previous = point;
+			}
+		}
+		else
+		{
+			const size_t first = size_t(blockIdx - numVertexBlocks) * BLOCK_SIZE, last = std::min<size_t>(first + BLOCK_SIZE, numFaces);
+			int64_t previous = 0;
+			block.reserve((last - first) * 4);
+
+			for (size_t faceIdx = first; faceIdx < last; ++faceIdx)
+			{
+				const uvec3& face = sortedFaces[faceIdx];
+
+				pushVarint(block, int64_t(face.x) - previous);
+				pushVarint(block, int64_t(face.y) - int64_t(face.x));
+				pushVarint(block, int64_t(face.z) - int64_t(face.x));
+
+				previous = face.x;
+			}
+		}
+	}
+
+	// Header, block sizes and blocks
+	Header header = {};
+	std::memcpy(header._magic, MAGIC, sizeof(MAGIC));
+	header._version = VERSION;
+	header._origin = grid._origin;
+	header._step = grid._step;
+	header._numVertices = numUsedVertices;
+	header._numFaces = static_cast<uint32_t>(numFaces);
+	header._numVertexBlocks = numVertexBlocks;
+	header._numFaceBlocks = numFaceBlocks;
+
+	std::vector<size_t> blockOffset(numBlocks + 1);
+	blockOffset[0] = sizeof(Header) + numBlocks * sizeof(uint32_t);
+	for (int blockIdx = 0; blockIdx < numBlocks; ++blockIdx)
+		blockOffset[blockIdx + 1] = blockOffset[blockIdx] + blocks[blockIdx].size();
+
+	data.resize(blockOffset[numBlocks]);
+	std::memcpy(data.data(), &header, sizeof(Header));
+
+#pragma omp parallel for
+	for (int blockIdx = 0; blockIdx < numBlocks; ++blockIdx)
+	{
+		const uint32_t blockSize = static_cast<uint32_t>(blocks[blockIdx].size());
+		std::memcpy(data.data() + sizeof(Header) + blockIdx * sizeof(uint32_t), &blockSize, sizeof(uint32_t));
+		std::copy(blocks[blockIdx].begin(), blocks[blockIdx].end(), data.begin() + blockOffset[blockIdx]);
+	}
+}
+
+// [Protected methods]
+
+void MeshCodec::pushVarint(std::vector<char>& data, int64_t value)
+{
+	uint64_t zigzag = (uint64_t(value) << 1) ^ uint64_t(value >> 63);
+
+	while (zigzag >= 0x80)
+	{
+		data.push_back(static_cast<char>(zigzag | 0x80));
+		zigzag >>= 7;
+	}
+
+	data.push_back(static_cast<char>(zigzag));
+}
+
+bool MeshCodec::readVarint(const uint8_t*& ptr, const uint8_t* end, int64_t& value)
+{
+	uint64_t zigzag = 0;
+	unsigned shift = 0;
+
+	do
+	{
+		if (ptr == end || shift > 63) return false;
+
+		zigzag |= uint64_t(*ptr & 0x7F) << shift;
+		shift += 7;
+	} while (*ptr++ & 0x80);
+
+	value = static_cast<int64_t>(zigzag >> 1) ^ -static_cast<int64_t>(zigzag & 1);
+
+	return true;
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+/**
+*	@file MeshCodec.h
+*	@authors Alfonso Lpez Ruiz (alr00048@red.ujaen.es)
+*	@date 19/10/2026
+*/
+
+/**
+*	@brief Compact encoding of triangle meshes. Positions are quantized to a regular grid, faces are sorted along a Morton curve and 
+*	vertices renumbered by their first use, so that both positions and indices are stored as small deltas (zigzag varints). Data is 
+*	split into blocks which are encoded and decoded independently, hence concurrently.
+*/
+class MeshCodec
+{
+public:
+	static const std::string EXTENSION;							//!< File extension of encoded meshes
+
+	struct Quantization
+	{
+		vec3	_origin;										//!< Position of the first grid point
+		vec3	_step;											//!< Distance between grid points, zero to fit 16 bits per axis within the mesh boundaries
+	};
+
+protected:
+	static const char		MAGIC[4];							//!< File signature
+	static const unsigned	BLOCK_SIZE;							//!< Number of vertices or faces of every block
+	static const uint16_t	VERSION;							//!< Layout version
+
+	struct Header
+	{
+		char		_magic[4];									//!< File signature
+		uint16_t	_version;									//!< Layout version
+		uint16_t	_reserved;									//!< Padding, zero
+		vec3		_origin;									//!< Position of the first grid point
+		vec3		_step;										//!< Distance between grid points
+		uint32_t	_numVertices;								//!< Number of vertices
+		uint32_t	_numFaces;									//!< Number of triangles
+		uint32_t	_numVertexBlocks;							//!< Number of blocks of vertices
+		uint32_t	_numFaceBlocks;								//!< Number of blocks of faces
+	};
+
+protected:
+	/**
+	*	@brief Appends a zigzag varint.
+	*/
+	static void pushVarint(std::vector<char>& data, int64_t value);
+
+	/**
+	*	@brief Reads a zigzag varint, checking the end of the data.
+	*/
+	static bool readVarint(const uint8_t*& ptr, const uint8_t* end, int64_t& value);
+
+public:
+	/**
+	*	@brief Decodes a mesh.
+	*	@return False if the data is not a valid encoding.
+	*/
+	static bool decode(const char* data, size_t size, std::vector<vec3>& positions, std::vector<uvec3>& faces);
+
+	/**
+	*	@brief Encodes a mesh.
+	*/
+	static void encode(const std::vector<vec3>& positions, const std::vector<uvec3>& faces, const Quantization& quantization, std::vector<char>& data);
+};
+
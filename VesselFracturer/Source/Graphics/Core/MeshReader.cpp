@@ -0,0 +1,906 @@
+#include "stdafx.h"
+#include "MeshReader.h"
+
+#include <charconv>
+#include <cstring>
+
+#include "Graphics/Core/MeshCodec.h"
+#include "Utilities/MappedFile.h"
+
+// [Static attributes]
+
+const size_t MeshReader::CHUNK_SIZE = 1 << 22;
+
+// [Public methods]
+
+MeshReader::MeshReader()
+{
+}
+
+MeshReader::~MeshReader()
+{
+}
+
+bool MeshReader::isSupported(const std::string& filename)
+{
+	std::string extension = std::filesystem::path(filename).extension().string();
+	std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char character) { return std::tolower(character); });
+
+	return extension == ".obj" || extension == ".ply" || extension == ".stl" || extension == MeshCodec::EXTENSION;
+}
+
+bool MeshReader::read(const std::string& filename)
+{
+	_aabb = AABB();
+	_faces.clear();
+	_positions.clear();
+
+	if (!MeshReader::isSupported(filename)) return false;
+
+	MappedFile mappedFile;
+	if (!mappedFile.open(filename)) return false;
+
+	mappedFile.prefetch(0, mappedFile.size());
+
+	const char* begin = static_cast<const char*>(mappedFile.data());
+	const char* end = begin + mappedFile.size();
+
+	std::string extension = std::filesystem::path(filename).extension().string();
+	std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char character) { return std::tolower(character); });
+
+	bool success;
+	if (extension == ".obj")
+	{
+		success = this->readOBJ(begin, end);
+	}
+	else if (extension == ".ply")
+	{
+		success = this->readPLY(begin, end);
+	}
+	else if (extension == MeshCodec::EXTENSION)
+	{
+		success = MeshCodec::decode(begin, end - begin, _positions, _faces);
+	}
+	else
+	{
+		// Binary STL files may also start with "solid", hence their size is checked first
+		uint32_t numTriangles = 0;
+		if (end - begin >= 84) std::memcpy(&numTriangles, begin + 80, sizeof(uint32_t));
+
+		if (end - begin >= 84 && size_t(end - begin) == 84 + size_t(numTriangles) * 50)
+			success = this->readBinarySTL(begin, end);
+		else
+			success = startsWith(skipBlanks(begin, end), end, "solid") && this->readASCIISTL(begin, end);
+	}
+
+	if (!success || _faces.empty())
+	{
+		_faces.clear();
+		_positions.clear();
+
+		return false;
+	}
+
+	this->computeAABB();
+
+	return true;
+}
+
+// [Protected methods]
+
+void MeshReader::computeAABB()
+{
+	vec3 minPoint(INFINITY), maxPoint(-INFINITY);
+	const int numVertices = static_cast<int>(_positions.size());
+
+#pragma omp parallel
+	{
+		vec3 localMin(INFINITY), localMax(-INFINITY);
+
+#pragma omp for nowait
+		for (int vertexIdx = 0; vertexIdx < numVertices; ++vertexIdx)
+		{
+			localMin = glm::min(localMin, _positions[vertexIdx]);
+			localMax = glm::max(localMax, _positions[vertexIdx]);
+		}
+
+#pragma omp critical
+		{
+			minPoint = glm::min(minPoint, localMin);
+			maxPoint = glm::max(maxPoint, localMax);
+		}
+	}
+
+	_aabb = AABB(minPoint, maxPoint);
+}
+
+void MeshReader::getChunks(const char* begin, const char* end, std::vector<const char*>& chunks)
+{
+	chunks.clear();
+	chunks.push_back(begin);
+
+	while (chunks.back() != end)
+	{
+		const char* chunkEnd = size_t(end - chunks.back()) > CHUNK_SIZE ? getNextLine(chunks.back() + CHUNK_SIZE, end) : end;
+		chunks.push_back(chunkEnd);
+	}
+}
+
+const char* MeshReader::getNextLine(const char* ptr, const char* end)
+{
+	const char* lineBreak = static_cast<const char*>(std::memchr(ptr, '\n', end - ptr));
+
+	return lineBreak ? lineBreak + 1 : end;
+}
+
+size_t MeshReader::getSize(PlyType type)
+{
+	static const size_t size[] = { 1, 1, 2, 2, 4, 4, 4, 8, 0 };
+
+	return size[type];
+}
+
+MeshReader::PlyType MeshReader::getType(const std::string& name)
+{
+	static const std::unordered_map<std::string, PlyType> types = {
+		{ "char", PLY_INT8 }, { "int8", PLY_INT8 }, { "uchar", PLY_UINT8 }, { "uint8", PLY_UINT8 },
+		{ "short", PLY_INT16 }, { "int16", PLY_INT16 }, { "ushort", PLY_UINT16 }, { "uint16", PLY_UINT16 },
+		{ "int", PLY_INT32 }, { "int32", PLY_INT32 }, { "uint", PLY_UINT32 }, { "uint32", PLY_UINT32 },
+		{ "float", PLY_FLOAT32 }, { "float32", PLY_FLOAT32 }, { "double", PLY_FLOAT64 }, { "float64", PLY_FLOAT64 }
+	};
+
+	auto type = types.find(name);
+	return type != types.end() ? type->second : PLY_UNKNOWN;
+}
+
+bool MeshReader::parseFloat(const char*& ptr, const char* end, float& value)
+{
+	ptr = skipBlanks(ptr, end);
+	if (ptr != end && *ptr == '+') ++ptr;
+
+	const std::from_chars_result result = std::from_chars(ptr, end, value);
+	if (result.ec == std::errc::result_out_of_range)
+	{
+		// Denormals and huge values are clamped rather than rejected
+		double doubleValue;
+		if (std::from_chars(ptr, end, doubleValue).ec != std::errc()) return false;
+
+		value = static_cast<float>(doubleValue);
+	}
+	else if (result.ec != std::errc())
+	{
+		return false;
+	}
+
+	ptr = result.ptr;
+
+	return true;
+}
+
+bool MeshReader::parseInteger(const char*& ptr, const char* end, int64_t& value)
+{
+	ptr = skipBlanks(ptr, end);
+	if (ptr != end && *ptr == '+') ++ptr;
+
+	const std::from_chars_result result = std::from_chars(ptr, end, value);
+	if (result.ec != std::errc()) return false;
+
+	ptr = result.ptr;
+
+	return true;
+}
+
+double MeshReader::readScalar(const char* ptr, PlyType type, bool swapBytes)
+{
+	char bytes[8];
+	const size_t size = getSize(type);
+
+	std::memcpy(bytes, ptr, size);
+	if (swapBytes) std::reverse(bytes, bytes + size);
+
+	switch (type)
+	{
+	case PLY_INT8: return *reinterpret_cast<int8_t*>(bytes);
+	case PLY_UINT8: return *reinterpret_cast<uint8_t*>(bytes);
+	case PLY_INT16: { int16_t value; std::memcpy(&value, bytes, size); return value; }
+	case PLY_UINT16: { uint16_t value; std::memcpy(&value, bytes, size); return value; }
+	case PLY_INT32: { int32_t value; std::memcpy(&value, bytes, size); return value; }
+	case PLY_UINT32: { uint32_t value; std::memcpy(&value, bytes, size); return value; }
+	case PLY_FLOAT32: { float value; std::memcpy(&value, bytes, size); return value; }
+	case PLY_FLOAT64: { double value; std::memcpy(&value, bytes, size); return value; }
+	default: return .0;
+	}
+}
+
+bool MeshReader::readASCIISTL(const char* begin, const char* end)
+{
+	std::vector<const char*> chunks;
+	getChunks(begin, end, chunks);
+
+	const int numChunks = static_cast<int>(chunks.size()) - 1;
+	std::vector<std::vector<vec3>> chunkPositions(numChunks);
+	std::vector<char> chunkFailed(numChunks, false);
+
+#pragma omp parallel for
+	for (int chunkIdx = 0; chunkIdx < numChunks; ++chunkIdx)
+	{
+		const char* ptr = chunks[chunkIdx];
+		const char* chunkEnd = chunks[chunkIdx + 1];
+
+		while (ptr < chunkEnd && !chunkFailed[chunkIdx])
+		{
+			const char* lineEnd = getNextLine(ptr, chunkEnd);
+			ptr = skipBlanks(ptr, lineEnd);
+
+			if (startsWith(ptr, lineEnd, "vertex"))
+			{
+				vec3 position;
+				ptr += 6;
+
+				if (parseFloat(ptr, lineEnd, position.x) && parseFloat(ptr, lineEnd, position.y) && parseFloat(ptr, lineEnd, position.z))
+					chunkPositions[chunkIdx].push_back(position);
+				else
+					chunkFailed[chunkIdx] = true;
+			}
+
+			ptr = lineEnd;
+		}
+	}
+
+	if (std::find(chunkFailed.begin(), chunkFailed.end(), true) != chunkFailed.end()) return false;
+
+	// Positions of every chunk are concatenated in order
+	std::vector<size_t> chunkOffset(numChunks + 1, 0);
+	for (int chunkIdx = 0; chunkIdx < numChunks; ++chunkIdx)
+		chunkOffset[chunkIdx + 1] = chunkOffset[chunkIdx] + chunkPositions[chunkIdx].size();
+
+	if (chunkOffset[numChunks] % 3 != 0 || chunkOffset[numChunks] / 3 > std::numeric_limits<unsigned>::max() / 3) return false;
+
+	_positions.resize(chunkOffset[numChunks]);
+
+#pragma omp parallel for
+	for (int chunkIdx = 0; chunkIdx < numChunks; ++chunkIdx)
+		std::copy(chunkPositions[chunkIdx].begin(), chunkPositions[chunkIdx].end(), _positions.begin() + chunkOffset[chunkIdx]);
+
+	chunkPositions = std::vector<std::vector<vec3>>();
+
+	const int numFaces = static_cast<int>(_positions.size() / 3);
+	_faces.resize(numFaces);
+
+#pragma omp parallel for
+	for (int faceIdx = 0; faceIdx < numFaces; ++faceIdx)
+		_faces[faceIdx] = uvec3(unsigned(faceIdx) * 3) + uvec3(0, 1, 2);
+
+	this->weldVertices();
+
+	return true;
+}
+
+bool MeshReader::readBinarySTL(const char* begin, const char* end)
+{
+	uint32_t numTriangles;
+	std::memcpy(&numTriangles, begin + 80, sizeof(uint32_t));
+
+	if (numTriangles > std::numeric_limits<unsigned>::max() / 3) return false;
+
+	const int numFaces = static_cast<int>(numTriangles);
+	_positions.resize(size_t(numFaces) * 3);
+	_faces.resize(numFaces);
+
+	// Each record holds a normal, three vertices and an attribute count, 50 bytes in total
+#pragma omp parallel for
+	for (int faceIdx = 0; faceIdx < numFaces; ++faceIdx)
+	{
+		const char* record = begin + 84 + size_t(faceIdx) * 50;
+
+		std::memcpy(&_positions[size_t(faceIdx) * 3], record + sizeof(vec3), 3 * sizeof(vec3));
+		_faces[faceIdx] = uvec3(unsigned(faceIdx) * 3) + uvec3(0, 1, 2);
+	}
+
+	this->weldVertices();
+
+	return true;
+}
+
+bool MeshReader::readOBJ(const char* begin, const char* end)
+{
+	std::vector<const char*> chunks;
+	getChunks(begin, end, chunks);
+
+	const int numChunks = static_cast<int>(chunks.size()) - 1;
+	std::vector<size_t> chunkOffset(numChunks + 1, 0);
+
+	// Vertices are counted first, so that relative indices can be resolved and every index validated while parsing
+#pragma omp parallel for
+	for (int chunkIdx = 0; chunkIdx < numChunks; ++chunkIdx)
+	{
+		size_t numVertices = 0;
+
+		for (const char* ptr = chunks[chunkIdx]; ptr < chunks[chunkIdx + 1]; ptr = getNextLine(ptr, chunks[chunkIdx + 1]))
+		{
+			ptr = skipBlanks(ptr, chunks[chunkIdx + 1]);
+			numVertices += startsWith(ptr, chunks[chunkIdx + 1], "v");
+		}
+
+		chunkOffset[chunkIdx + 1] = numVertices;
+	}
+
+	for (int chunkIdx = 0; chunkIdx < numChunks; ++chunkIdx)
+		chunkOffset[chunkIdx + 1] += chunkOffset[chunkIdx];
+
+	const int64_t numVertices = static_cast<int64_t>(chunkOffset[numChunks]);
+	if (numVertices > std::numeric_limits<int>::max()) return false;
+
+	_positions.resize(numVertices);
+
+	std::vector<std::vector<uvec3>> chunkFaces(numChunks);
+	std::vector<char> chunkFailed(numChunks, false);
+
+#pragma omp parallel for
+	for (int chunkIdx = 0; chunkIdx < numChunks; ++chunkIdx)
+	{
+		const char* ptr = chunks[chunkIdx];
+		const char* chunkEnd = chunks[chunkIdx + 1];
+		size_t vertexIdx = chunkOffset[chunkIdx];
+		std::vector<unsigned> polygon;
+
+		while (ptr < chunkEnd && !chunkFailed[chunkIdx])
+		{
+			const char* lineEnd = getNextLine(ptr, chunkEnd);
+			ptr = skipBlanks(ptr, lineEnd);
+
+			if (startsWith(ptr, lineEnd, "v"))
+			{
+				vec3& position = _positions[vertexIdx++];
+				++ptr;
+
+				chunkFailed[chunkIdx] = !parseFloat(ptr, lineEnd, position.x) || !parseFloat(ptr, lineEnd, position.y) || !parseFloat(ptr, lineEnd, position.z);
+			}
+			else if (startsWith(ptr, lineEnd, "f"))
+			{
+				int64_t index;
+				polygon.clear();
+				++ptr;
+
+				while (parseInteger(ptr, lineEnd, index))
+				{
+					// Negative indices are relative to the last parsed vertex
+					index = index < 0 ? static_cast<int64_t>(vertexIdx) + index : index - 1;
+					if (index < 0 || index >= numVertices)
+					{
+						chunkFailed[chunkIdx] = true;
+						break;
+					}
+
+					polygon.push_back(static_cast<unsigned>(index));
+
+					// Texture coordinates and normals are skipped
+					while (ptr < lineEnd && *ptr != ' ' && *ptr != '\t' && *ptr != '\r' && *ptr != '\n') ++ptr;
+				}
+
+				if (polygon.size() < 3)
+					chunkFailed[chunkIdx] = true;
+
+				for (size_t vertex = 2; vertex < polygon.size(); ++vertex)
+					chunkFaces[chunkIdx].push_back(uvec3(polygon[0], polygon[vertex - 1], polygon[vertex]));
+			}
+
+			ptr = lineEnd;
+		}
+	}
+
+	if (std::find(chunkFailed.begin(), chunkFailed.end(), true) != chunkFailed.end()) return false;
+
+	std::vector<size_t> faceOffset(numChunks + 1, 0);
+	for (int chunkIdx = 0; chunkIdx < numChunks; ++chunkIdx)
+		faceOffset[chunkIdx + 1] = faceOffset[chunkIdx] + chunkFaces[chunkIdx].size();
+
+	_faces.resize(faceOffset[numChunks]);
+
+#pragma omp parallel for
+	for (int chunkIdx = 0; chunkIdx < numChunks; ++chunkIdx)
+		std::copy(chunkFaces[chunkIdx].begin(), chunkFaces[chunkIdx].end(), _faces.begin() + faceOffset[chunkIdx]);
+
+	return true;
+}
+
+bool MeshReader::readPLY(const char* begin, const char* end)
+{
+	if (!startsWith(begin, end, "ply")) return false;
+
+	std::vector<PlyElement> elements;
+	std::string format;
+	const char* ptr = getNextLine(begin, end);
+
+	while (true)
+	{
+		if (ptr == end) return false;
+
+		const char* lineEnd = getNextLine(ptr, end);
+		std::istringstream line(std::string(ptr, lineEnd));
+		std::string keyword;
+		line >> keyword;
+		ptr = lineEnd;
+
+		if (keyword == "end_header")
+		{
+			break;
+		}
+		else if (keyword == "format")
+		{
+			line >> format;
+		}
+		else if (keyword == "element")
+		{
+			PlyElement element;
+			if (!(line >> element._name >> element._count)) return false;
+
+			elements.push_back(element);
+		}
+		else if (keyword == "property")
+		{
+			PlyProperty property;
+			std::string type;
+			if (elements.empty() || !(line >> type)) return false;
+
+			property._list = type == "list";
+			if (property._list)
+			{
+				std::string countType;
+				if (!(line >> countType >> type)) return false;
+
+				property._countType = getType(countType);
+				if (property._countType == PLY_UNKNOWN || property._countType == PLY_FLOAT32 || property._countType == PLY_FLOAT64) return false;
+			}
+
+			property._type = getType(type);
+			if (property._type == PLY_UNKNOWN || !(line >> property._name)) return false;
+
+			elements.back()._properties.push_back(property);
+		}
+	}
+
+	if (format == "ascii")
+		return this->readPLYASCII(ptr, end, elements);
+	else if (format == "binary_little_endian" || format == "binary_big_endian")
+		return this->readPLYBinary(ptr, end, elements, format == "binary_big_endian");
+
+	return false;
+}
+
+bool MeshReader::readPLYASCII(const char* begin, const char* end, const std::vector<PlyElement>& elements)
+{
+	// Every record takes one (non-empty) line, hence lines are numbered so that each one can be assigned to its element
+	std::vector<const char*> chunks;
+	getChunks(begin, end, chunks);
+
+	const int numChunks = static_cast<int>(chunks.size()) - 1;
+	std::vector<size_t> chunkLine(numChunks + 1, 0);
+
+	auto isEmpty = [](const char* ptr, const char* lineEnd) {
+		ptr = skipBlanks(ptr, lineEnd);
+		return ptr == lineEnd || *ptr == '\r' || *ptr == '\n';
+	};
+
+#pragma omp parallel for
+	for (int chunkIdx = 0; chunkIdx < numChunks; ++chunkIdx)
+	{
+		size_t numLines = 0;
+
+		for (const char* ptr = chunks[chunkIdx]; ptr < chunks[chunkIdx + 1]; )
+		{
+			const char* lineEnd = getNextLine(ptr, chunks[chunkIdx + 1]);
+			numLines += !isEmpty(ptr, lineEnd);
+			ptr = lineEnd;
+		}
+
+		chunkLine[chunkIdx + 1] = numLines;
+	}
+
+	for (int chunkIdx = 0; chunkIdx < numChunks; ++chunkIdx)
+		chunkLine[chunkIdx + 1] += chunkLine[chunkIdx];
+
+	// Line range and layout of vertices and faces
+	size_t firstLine = 0, vertexLine = 0, faceLine = 0, numVertices = 0, numFaces = 0;
+	int xProperty = -1, yProperty = -1, zProperty = -1, indexProperty = -1;
+	const PlyElement *vertexElement = nullptr, *faceElement = nullptr;
+
+	for (const PlyElement& element : elements)
+	{
+		if (element._name == "vertex")
+		{
+			vertexElement = &element;
+			vertexLine = firstLine;
+			numVertices = element._count;
+
+			for (int propertyIdx = 0; propertyIdx < static_cast<int>(element._properties.size()); ++propertyIdx)
+			{
+				const PlyProperty& property = element._properties[propertyIdx];
+				if (property._list) return false;
+
+				if (property._name == "x") xProperty = propertyIdx;
+				else if (property._name == "y") yProperty = propertyIdx;
+				else if (property._name == "z") zProperty = propertyIdx;
+			}
+		}
+		else if (element._name == "face")
+		{
+			faceElement = &element;
+			faceLine = firstLine;
+			numFaces = element._count;
+
+			for (int propertyIdx = 0; propertyIdx < static_cast<int>(element._properties.size()); ++propertyIdx)
+			{
+				const PlyProperty& property = element._properties[propertyIdx];
+				if (property._list && (property._name == "vertex_indices" || property._name == "vertex_index")) indexProperty = propertyIdx;
+			}
+		}
+
+		firstLine += element._count;
+	}
+
+	if (!vertexElement || !faceElement || xProperty < 0 || yProperty < 0 || zProperty < 0 || indexProperty < 0) return false;
+	if (chunkLine[numChunks] < firstLine || numVertices > size_t(std::numeric_limits<int>::max())) return false;
+
+	_positions.resize(numVertices);
+
+	std::vector<std::vector<uvec3>> chunkFaces(numChunks);
+	std::vector<char> chunkFailed(numChunks, false);
+
+#pragma omp parallel for
+	for (int chunkIdx = 0; chunkIdx < numChunks; ++chunkIdx)
+	{
+		const char* ptr = chunks[chunkIdx];
+		const char* chunkEnd = chunks[chunkIdx + 1];
+		size_t lineIdx = chunkLine[chunkIdx];
+		std::vector<unsigned> polygon;
+
+		while (ptr < chunkEnd && !chunkFailed[chunkIdx])
+		{
+			const char* lineEnd = getNextLine(ptr, chunkEnd);
+
+			if (isEmpty(ptr, lineEnd))
+			{
+				ptr = lineEnd;
+				continue;
+			}
+
+			if (lineIdx >= vertexLine && lineIdx < vertexLine + numVertices)
+			{
+				vec3& position = _positions[lineIdx - vertexLine];
+				float value;
+
+				for (int propertyIdx = 0; propertyIdx < static_cast<int>(vertexElement->_properties.size()) && !chunkFailed[chunkIdx]; ++propertyIdx)
+				{
+					chunkFailed[chunkIdx] = !parseFloat(ptr, lineEnd, value);
+
+					if (propertyIdx == xProperty) position.x = value;
+					else if (propertyIdx == yProperty) position.y = value;
+					else if (propertyIdx == zProperty) position.z = value;
+				}
+			}
+			else if (lineIdx >= faceLine && lineIdx < faceLine + numFaces)
+			{
+				for (int propertyIdx = 0; propertyIdx < static_cast<int>(faceElement->_properties.size()) && !chunkFailed[chunkIdx]; ++propertyIdx)
+				{
+					int64_t count = 1, value;
+					if (faceElement->_properties[propertyIdx]._list && !parseInteger(ptr, lineEnd, count))
+					{
+						chunkFailed[chunkIdx] = true;
+						break;
+					}
+
+					polygon.clear();
+					for (int64_t itemIdx = 0; itemIdx < count && !chunkFailed[chunkIdx]; ++itemIdx)
+					{
+						float realValue;
+						if (faceElement->_properties[propertyIdx]._type == PLY_FLOAT32 || faceElement->_properties[propertyIdx]._type == PLY_FLOAT64)
+							chunkFailed[chunkIdx] = !parseFloat(ptr, lineEnd, realValue);
+						else if (!parseInteger(ptr, lineEnd, value))
+							chunkFailed[chunkIdx] = true;
+						else if (propertyIdx == indexProperty)
+						{
+							if (value < 0 || value >= static_cast<int64_t>(numVertices))
+								chunkFailed[chunkIdx] = true;
+							else
+								polygon.push_back(static_cast<unsigned>(value));
+						}
+					}
+
+					if (propertyIdx == indexProperty)
+					{
+						if (polygon.size() < 3) chunkFailed[chunkIdx] = true;
+
+						for (size_t vertex = 2; vertex < polygon.size(); ++vertex)
+							chunkFaces[chunkIdx].push_back(uvec3(polygon[0], polygon[vertex - 1], polygon[vertex]));
+					}
+				}
+			}
+
+			++lineIdx;
+			ptr = lineEnd;
+		}
+	}
+
+	if (std::find(chunkFailed.begin(), chunkFailed.end(), true) != chunkFailed.end()) return false;
+
+	std::vector<size_t> faceOffset(numChunks + 1, 0);
+	for (int chunkIdx = 0; chunkIdx < numChunks; ++chunkIdx)
+		faceOffset[chunkIdx + 1] = faceOffset[chunkIdx] + chunkFaces[chunkIdx].size();
+
+	_faces.resize(faceOffset[numChunks]);
+
+#pragma omp parallel for
+	for (int chunkIdx = 0; chunkIdx < numChunks; ++chunkIdx)
+		std::copy(chunkFaces[chunkIdx].begin(), chunkFaces[chunkIdx].end(), _faces.begin() + faceOffset[chunkIdx]);
+
+	return true;
+}
+
+bool MeshReader::readPLYBinary(const char* begin, const char* end, const std::vector<PlyElement>& elements, bool swapBytes)
+{
+	const char* ptr = begin;
+	bool vertexFound = false, faceFound = false;
+
+	for (const PlyElement& element : elements)
+	{
+		// Fixed-size part of every record, and offset of its first list
+		size_t stride = 0, listOffset = 0;
+		int numLists = 0;
+
+		for (const PlyProperty& property : element._properties)
+		{
+			if (property._list)
+			{
+				if (numLists++ == 0) listOffset = stride;
+				stride += getSize(property._countType);
+			}
+			else
+			{
+				stride += getSize(property._type);
+			}
+		}
+
+		if (element._name == "vertex")
+		{
+			if (numLists || element._count > size_t(std::numeric_limits<int>::max()) || element._count * stride > size_t(end - ptr)) return false;
+
+			size_t offset[3] = { 0, 0, 0 }, propertyOffset = 0;
+			PlyType type[3] = { PLY_UNKNOWN, PLY_UNKNOWN, PLY_UNKNOWN };
+
+			for (const PlyProperty& property : element._properties)
+			{
+				const int axis = property._name == "x" ? 0 : (property._name == "y" ? 1 : (property._name == "z" ? 2 : -1));
+				if (axis >= 0)
+				{
+					offset[axis] = propertyOffset;
+					type[axis] = property._type;
+				}
+
+				propertyOffset += getSize(property._type);
+			}
+
+			if (type[0] == PLY_UNKNOWN || type[1] == PLY_UNKNOWN || type[2] == PLY_UNKNOWN) return false;
+
+			const int numVertices = static_cast<int>(element._count);
+			const bool packedFloats = !swapBytes && type[0] == PLY_FLOAT32 && type[1] == PLY_FLOAT32 && type[2] == PLY_FLOAT32 && offset[1] == offset[0] + 4 && offset[2] == offset[0] + 8;
+			_positions.resize(numVertices);
+
+#pragma omp parallel for
+			for (int vertexIdx = 0; vertexIdx < numVertices; ++vertexIdx)
+			{
+				const char* record = ptr + size_t(vertexIdx) * stride;
+
+				if (packedFloats)
+					std::memcpy(&_positions[vertexIdx], record + offset[0], sizeof(vec3));
+				else
+					_positions[vertexIdx] = vec3(readScalar(record + offset[0], type[0], swapBytes), readScalar(record + offset[1], type[1], swapBytes), readScalar(record + offset[2], type[2], swapBytes));
+			}
+
+			ptr += element._count * stride;
+			vertexFound = true;
+		}
+		else if (element._name == "face")
+		{
+			if (numLists != 1) return false;
+
+			const PlyProperty& list = *std::find_if(element._properties.begin(), element._properties.end(), [](const PlyProperty& property) { return property._list; });
+			if (list._name != "vertex_indices" && list._name != "vertex_index") return false;
+			if (list._type == PLY_FLOAT32 || list._type == PLY_FLOAT64 || element._count > size_t(std::numeric_limits<int>::max())) return false;
+
+			// Triangle meshes have fixed-size records, which are parsed concurrently. Any other polygon is found at its right place, since
+			// every preceding record is a triangle, and forces a sequential parse
+			const int numFaces = static_cast<int>(element._count);
+			const size_t indexSize = getSize(list._type), triangleStride = stride + 3 * indexSize;
+			bool onlyTriangles = element._count * triangleStride <= size_t(end - ptr);
+
+			if (onlyTriangles)
+			{
+				_faces.resize(numFaces);
+
+#pragma omp parallel for reduction(&&: onlyTriangles)
+				for (int faceIdx = 0; faceIdx < numFaces; ++faceIdx)
+				{
+					const char* record = ptr + size_t(faceIdx) * triangleStride + listOffset;
+					if (readScalar(record, list._countType, swapBytes) != 3.0)
+					{
+						onlyTriangles = false;
+						continue;
+					}
+
+					record += getSize(list._countType);
+					for (int vertex = 0; vertex < 3; ++vertex)
+						_faces[faceIdx][vertex] = static_cast<unsigned>(readScalar(record + vertex * indexSize, list._type, swapBytes));
+				}
+			}
+
+			if (onlyTriangles)
+			{
+				ptr += element._count * triangleStride;
+			}
+			else
+			{
+				std::vector<unsigned> polygon;
+				_faces.clear();
+
+				for (int faceIdx = 0; faceIdx < numFaces; ++faceIdx)
+				{
+					if (size_t(end - ptr) < stride) return false;
+
+					const size_t count = static_cast<size_t>(readScalar(ptr + listOffset, list._countType, swapBytes));
+					const char* indices = ptr + listOffset + getSize(list._countType);
+					if (count < 3 || size_t(end - ptr) < stride + count * indexSize) return false;
+
+					polygon.resize(count);
+					for (size_t vertex = 0; vertex < count; ++vertex)
+						polygon[vertex] = static_cast<unsigned>(readScalar(indices + vertex * indexSize, list._type, swapBytes));
+
+					for (size_t vertex = 2; vertex < count; ++vertex)
+						_faces.push_back(uvec3(polygon[0], polygon[vertex - 1], polygon[vertex]));
+
+					ptr += stride + count * indexSize;
+				}
+			}
+
+			faceFound = true;
+		}
+		else
+		{
+			// Only fixed-size elements can be skipped without parsing them
+			if (numLists || element._count * stride > size_t(end - ptr)) return false;
+
+			ptr += element._count * stride;
+		}
+	}
+
+	if (!vertexFound || !faceFound) return false;
+
+	// Indices are validated once both elements are known
+	const unsigned numVertices = static_cast<unsigned>(_positions.size());
+	const int numFaces = static_cast<int>(_faces.size());
+	bool validIndices = true;
+
+#pragma omp parallel for reduction(&&: validIndices)
+	for (int faceIdx = 0; faceIdx < numFaces; ++faceIdx)
+	{
+		if (glm::any(glm::greaterThanEqual(_faces[faceIdx], uvec3(numVertices))))
+			validIndices = false;
+	}
+
+	return validIndices;
+}
+
+const char* MeshReader::skipBlanks(const char* ptr, const char* end)
+{
+	while (ptr < end && (*ptr == ' ' || *ptr == '\t')) ++ptr;
+
+	return ptr;
+}
+
+bool MeshReader::startsWith(const char* ptr, const char* end, const char* keyword)
+{
+	while (*keyword)
+	{
+		if (ptr == end || *ptr != *keyword) return false;
+
+		++ptr;
+		++keyword;
+	}
+
+	return ptr == end || *ptr == ' ' || *ptr == '\t' || *ptr == '\r' || *ptr == '\n';
+}
+
+void MeshReader::weldVertices()
+{
+	const int numVertices = static_cast<int>(_positions.size());
+	if (numVertices == 0) return;
+
+	unsigned numBuckets = 1;
+	while (numBuckets < 2 * unsigned(numVertices) && numBuckets < (1u << 31)) numBuckets <<= 1;
+
+	// Identical positions share their bit pattern once negative zeros are removed, which also keeps NaN values comparable
+	auto getKey = [&](int vertexIdx) {
+		const vec3 position = _positions[vertexIdx] + vec3(.0f);
+		uvec3 bits;
+		std::memcpy(&bits, &position, sizeof(uvec3));
+
+		return bits;
+	};
+
+	// Low mantissa bits are often zero, hence they are mixed with the upper ones
+	auto getBucket = [&](const uvec3& key) {
+		uint64_t hash = (uint64_t(key.x) << 32 | key.y) * 0x9E3779B97F4A7C15ull ^ uint64_t(key.z) * 0xC2B2AE3D27D4EB4Full;
+		hash ^= hash >> 29;
+		hash *= 0xBF58476D1CE4E5B9ull;
+		hash ^= hash >> 32;
+
+		return unsigned(hash) & (numBuckets - 1);
+	};
+
+	std::vector<unsigned> vertexBucket(numVertices), bucketOffset(numBuckets + 1, 0), bucketVertices(numVertices);
+	std::vector<uvec3> bucketKeys(numVertices);
+
+#pragma omp parallel for
+	for (int vertexIdx = 0; vertexIdx < numVertices; ++vertexIdx)
+		vertexBucket[vertexIdx] = getBucket(getKey(vertexIdx));
+
+	for (int vertexIdx = 0; vertexIdx < numVertices; ++vertexIdx)
+		++bucketOffset[vertexBucket[vertexIdx] + 1];
+
+	for (unsigned bucket = 0; bucket < numBuckets; ++bucket)
+		bucketOffset[bucket + 1] += bucketOffset[bucket];
+
+	std::vector<unsigned> bucketCursor(bucketOffset.begin(), bucketOffset.end() - 1);
+	for (int vertexIdx = 0; vertexIdx < numVertices; ++vertexIdx)
+	{
+		const unsigned offset = bucketCursor[vertexBucket[vertexIdx]]++;
+		bucketVertices[offset] = vertexIdx;
+		bucketKeys[offset] = getKey(vertexIdx);
+	}
+
+	bucketCursor = std::vector<unsigned>();
+	vertexBucket = std::vector<unsigned>();
+
+	// Every vertex is represented by the first one with the same position, which lies earlier in its own bucket
+	std::vector<unsigned> representative(numVertices);
+
+#pragma omp parallel for
+	for (int bucket = 0; bucket < static_cast<int>(numBuckets); ++bucket)
+	{
+		for (unsigned offset = bucketOffset[bucket]; offset < bucketOffset[bucket + 1]; ++offset)
+		{
+			unsigned first = bucketOffset[bucket];
+			while (bucketKeys[first] != bucketKeys[offset]) ++first;
+
+			representative[bucketVertices[offset]] = bucketVertices[first];
+		}
+	}
+
+	bucketKeys = std::vector<uvec3>();
+	bucketOffset = std::vector<unsigned>();
+	bucketVertices = std::vector<unsigned>();
+
+	// Representatives keep their relative order
+	std::vector<unsigned> newIndex(numVertices);
+	unsigned numWelded = 0;
+
+	for (int vertexIdx = 0; vertexIdx < numVertices; ++vertexIdx)
+		if (representative[vertexIdx] == unsigned(vertexIdx))
+			newIndex[vertexIdx] = numWelded++;
+
+	std::vector<vec3> positions(numWelded);
+
+#pragma omp parallel for
+	for (int vertexIdx = 0; vertexIdx < numVertices; ++vertexIdx)
+		if (representative[vertexIdx] == unsigned(vertexIdx))
+			positions[newIndex[vertexIdx]] = _positions[vertexIdx];
+
+	const int numFaces = static_cast<int>(_faces.size());
+
+#pragma omp parallel for
+	for (int faceIdx = 0; faceIdx < numFaces; ++faceIdx)
+		for (int vertex = 0; vertex < 3; ++vertex)
+			_faces[faceIdx][vertex] = newIndex[representative[_faces[faceIdx][vertex]]];
+
+	_positions = std::move(positions);
+}
@@ -0,0 +1,166 @@
+#pragma once
+
+#include "Geometry/3D/AABB.h"
+
+/**
+*	@file MeshReader.h
+*	@authors Alfonso Lpez Ruiz (alr00048@red.ujaen.es)
+*	@date 19/10/2026
+*/
+
+/**
+*	@brief Lean loader of STL (binary and ASCII), OBJ, PLY (binary and ASCII) and quantized (MeshCodec) files, which only retrieves positions and triangles. 
+*	Files are memory-mapped and text is parsed in chunks of whole lines concurrently. Any unsupported variant is rejected, so that the 
+*	caller can fall back to a general-purpose importer.
+*/
+class MeshReader
+{
+protected:
+	static const size_t CHUNK_SIZE;								//!< Number of bytes of text parsed by each task
+
+	enum PlyType { PLY_INT8, PLY_UINT8, PLY_INT16, PLY_UINT16, PLY_INT32, PLY_UINT32, PLY_FLOAT32, PLY_FLOAT64, PLY_UNKNOWN };
+
+	struct PlyProperty
+	{
+		PlyType				_countType;							//!< Type of the number of items, only for lists
+		bool				_list;								//!< The property is a list of values
+		std::string			_name;								//!< Name of the property
+		PlyType				_type;								//!< Type of the value, or of every item of a list
+	};
+
+	struct PlyElement
+	{
+		size_t						_count;						//!< Number of records
+		std::string					_name;						//!< Name of the element
+		std::vector<PlyProperty>	_properties;				//!< Properties of every record
+	};
+
+protected:
+	AABB					_aabb;								//!< Boundaries of the positions
+	std::vector<uvec3>		_faces;								//!< Vertex indices of each triangle
+	std::vector<vec3>		_positions;							//!< Vertex positions
+
+protected:
+	/**
+	*	@brief Computes the boundaries of the positions through a parallel reduction.
+	*/
+	void computeAABB();
+
+	/**
+	*	@brief Splits the text into chunks of whole lines, whose boundaries are returned (including both ends).
+	*/
+	static void getChunks(const char* begin, const char* end, std::vector<const char*>& chunks);
+
+	/**
+	*	@return Pointer to the first character of the following line.
+	*/
+	static const char* getNextLine(const char* ptr, const char* end);
+
+	/**
+	*	@return Size in bytes of a PLY type.
+	*/
+	static size_t getSize(PlyType type);
+
+	/**
+	*	@return PLY type from its name, PLY_UNKNOWN if not valid.
+	*/
+	static PlyType getType(const std::string& name);
+
+	/**
+	*	@brief Parses a real number, skipping the preceding blanks.
+	*/
+	static bool parseFloat(const char*& ptr, const char* end, float& value);
+
+	/**
+	*	@brief Parses an integer, skipping the preceding blanks.
+	*/
+	static bool parseInteger(const char*& ptr, const char* end, int64_t& value);
+
+	/**
+	*	@brief Reads a binary scalar of the given type, swapping its bytes if it is stored as big-endian.
+	*/
+	static double readScalar(const char* ptr, PlyType type, bool swapBytes);
+
+	/**
+	*	@brief Parses an ASCII STL file.
+	*/
+	bool readASCIISTL(const char* begin, const char* end);
+
+	/**
+	*	@brief Parses a binary STL file.
+	*/
+	bool readBinarySTL(const char* begin, const char* end);
+
+	/**
+	*	@brief Parses an OBJ file, triangulating polygons as fans.
+	*/
+	bool readOBJ(const char* begin, const char* end);
+
+	/**
+	*	@brief Parses a PLY file, triangulating polygons as fans.
+	*/
+	bool readPLY(const char* begin, const char* end);
+
+	/**
+	*	@brief Parses the body of an ASCII PLY file.
+	*/
+	bool readPLYASCII(const char* begin, const char* end, const std::vector<PlyElement>& elements);
+
+	/**
+	*	@brief Parses the body of a binary PLY file.
+	*/
+	bool readPLYBinary(const char* begin, const char* end, const std::vector<PlyElement>& elements, bool swapBytes);
+
+	/**
+	*	@return Pointer to the first character which is neither a space nor a tab.
+	*/
+	static const char* skipBlanks(const char* ptr, const char* end);
+
+	/**
+	*	@brief Checks whether the line starts with the given keyword, followed by a blank or the end of the line.
+	*/
+	static bool startsWith(const char* ptr, const char* end, const char* keyword);
+
+	/**
+	*	@brief Merges vertices with identical positions, as triangles of STL files do not share them.
+	*/
+	void weldVertices();
+
+public:
+	/**
+	*	@brief Constructor.
+	*/
+	MeshReader();
+
+	/**
+	*	@brief Destructor.
+	*/
+	virtual ~MeshReader();
+
+	/**
+	*	@return Boundaries of the positions.
+	*/
+	const AABB& getAABB() const { return _aabb; }
+
+	/**
+	*	@return Vertex indices of each triangle.
+	*/
+	const std::vector<uvec3>& getFaces() const { return _faces; }
+
+	/**
+	*	@return Vertex positions.
+	*/
+	const std::vector<vec3>& getPositions() const { return _positions; }
+
+	/**
+	*	@brief Checks whether the extension of the filename corresponds to a supported format.
+	*/
+	static bool isSupported(const std::string& filename);
+
+	/**
+	*	@brief Loads a mesh, discarding the previous one.
+	*	@return False if the file could not be opened or its content is not supported.
+	*/
+	bool read(const std::string& filename);
+};
+
@@ -0,0 +1,43 @@
+#pragma once
+
+/**
+*	@file MeshSink.h
+*	@authors Alfonso Lpez Ruiz (alr00048@red.ujaen.es)
+*	@date 19/10/2026
+*/
+
+/**
+*	@brief Destination of a triangle mesh which is written incrementally. The sizes of the mesh are announced first, then vertices are 
+*	written before the faces which index them. Both may be split into any number of calls, so that producers never gather the whole mesh 
+*	into an intermediate buffer.
+*/
+class MeshSink
+{
+public:
+	/**
+	*	@brief Destructor.
+	*/
+	virtual ~MeshSink() {}
+
+	/**
+	*	@brief Starts a new mesh with the given number of vertices and faces.
+	*	@return False if the mesh cannot be written.
+	*/
+	virtual bool begin(size_t numVertices, size_t numFaces) = 0;
+
+	/**
+	*	@brief Finishes the current mesh.
+	*	@return False if the written mesh does not match the announced sizes or could not be stored.
+	*/
+	virtual bool end() = 0;
+
+	/**
+	*	@brief Appends faces, whose indices refer to the whole mesh rather than to this batch. The fourth component is ignored.
+	*/
+	virtual void writeFaces(const uvec4* faces, size_t numFaces) = 0;
+
+	/**
+	*	@brief Appends vertices. The fourth component is ignored.
+	*/
+	virtual void writeVertices(const vec4* vertices, size_t numVertices) = 0;
+};
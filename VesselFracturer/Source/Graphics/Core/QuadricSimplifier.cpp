@@ -0,0 +1,362 @@
+#include "stdafx.h"
+#include "QuadricSimplifier.h"
+
+#include <cstring>
+
+/// [Public methods]
+
+QuadricSimplifier::QuadricSimplifier(double aggressiveness, unsigned maxIterations) :
+	_aggressiveness(aggressiveness), _maxIterations(maxIterations)
+{
+}
+
+QuadricSimplifier::~QuadricSimplifier()
+{
+}
+
+void QuadricSimplifier::releaseMemory()
+{
+	std::vector<Triangle>().swap(_triangles);
+	std::vector<Vertex>().swap(_vertices);
+	std::vector<Ref>().swap(_refs);
+	std::vector<char>().swap(_deleted0);
+	std::vector<char>().swap(_deleted1);
+	std::vector<int>().swap(_neighbourCount);
+	std::vector<int>().swap(_neighbourId);
+}
+
+bool QuadricSimplifier::simplify(Model3D::ModelComponent* modelComponent, unsigned numFaces)
+{
+	if (modelComponent->_topology.size() <= numFaces) return false;
+
+	_vertices.resize(modelComponent->_geometry.size());
+	_triangles.resize(modelComponent->_topology.size());
+
+	for (size_t vertexIdx = 0; vertexIdx < _vertices.size(); ++vertexIdx)
+	{
+		Vertex& vertex = _vertices[vertexIdx];
+		vertex = Vertex();
+		vertex._position = glm::dvec3(modelComponent->_geometry[vertexIdx]._position);
+	}
+
+	for (size_t faceIdx = 0; faceIdx < _triangles.size(); ++faceIdx)
+	{
+		Triangle& triangle = _triangles[faceIdx];
+		triangle = Triangle();
+		for (int i = 0; i < 3; ++i) triangle._v[i] = static_cast<int>(modelComponent->_topology[faceIdx]._vertices[i]);
+	}
+
+	this->simplify(numFaces);
+
+	modelComponent->_geometry.resize(_vertices.size());
+	modelComponent->_topology.resize(_triangles.size());
+
+	for (size_t vertexIdx = 0; vertexIdx < _vertices.size(); ++vertexIdx)
+		modelComponent->_geometry[vertexIdx]._position = vec3(_vertices[vertexIdx]._position);
+
+	for (size_t faceIdx = 0; faceIdx < _triangles.size(); ++faceIdx)
+		modelComponent->_topology[faceIdx]._vertices = uvec3(_triangles[faceIdx]._v[0], _triangles[faceIdx]._v[1], _triangles[faceIdx]._v[2]);
+
+	return true;
+}
+
+/// [Protected methods]
+
+double QuadricSimplifier::calculateError(int v1, int v2, glm::dvec3& position) const
+{
+	const Quadric quadric = _vertices[v1]._quadric + _vertices[v2]._quadric;
+	const bool border = _vertices[v1]._border && _vertices[v2]._border;
+	const double det = quadric.det(0, 1, 2, 1, 4, 5, 2, 5, 7);
+
+	if (det != 0 && !border)
+	{
+		position.x = -1 / det * quadric.det(1, 2, 3, 4, 5, 6, 5, 7, 8);
+		position.y = 1 / det * quadric.det(0, 2, 3, 1, 5, 6, 2, 7, 8);
+		position.z = -1 / det * quadric.det(0, 1, 3, 1, 4, 6, 2, 5, 8);
+
+		return quadric.error(position);
+	}
+
+	// Not invertible, pick the best among the endpoints and the midpoint
+	const glm::dvec3 candidates[3] = { _vertices[v1]._position, _vertices[v2]._position, (_vertices[v1]._position + _vertices[v2]._position) / 2.0 };
+	const double errors[3] = { quadric.error(candidates[0]), quadric.error(candidates[1]), quadric.error(candidates[2]) };
+	const double error = std::min(errors[0], std::min(errors[1], errors[2]));
+
+	for (int i = 0; i < 3; ++i)
+		if (errors[i] == error) position = candidates[i];
+
+	return error;
+}
+
+void QuadricSimplifier::compactMesh()
+{
+	int dst = 0;
+
+	for (Vertex& vertex : _vertices) vertex._refCount = 0;
+
+	for (size_t triangleIdx = 0; triangleIdx < _triangles.size(); ++triangleIdx)
+	{
+		if (!_triangles[triangleIdx]._deleted)
+		{
+			const Triangle& triangle = _triangles[dst++] = _triangles[triangleIdx];
+			for (int i = 0; i < 3; ++i) _vertices[triangle._v[i]]._refCount = 1;
+		}
+	}
+	_triangles.resize(dst);
+
+	// Vertices are renumbered in place, _refStart holds the new index
+	dst = 0;
+	for (size_t vertexIdx = 0; vertexIdx < _vertices.size(); ++vertexIdx)
+	{
+		if (_vertices[vertexIdx]._refCount)
+		{
+			_vertices[vertexIdx]._refStart = dst;
+			_vertices[dst++]._position = _vertices[vertexIdx]._position;
+		}
+	}
+
+	for (Triangle& triangle : _triangles)
+		for (int i = 0; i < 3; ++i) triangle._v[i] = _vertices[triangle._v[i]]._refStart;
+
+	_vertices.resize(dst);
+}
+
+bool QuadricSimplifier::flipped(const glm::dvec3& position, int v1, const Vertex& v0, std::vector<char>& deleted) const
+{
+	for (int k = 0; k < v0._refCount; ++k)
+	{
+		const Ref& ref = _refs[v0._refStart + k];
+		const Triangle& triangle = _triangles[ref._triangle];
+		if (triangle._deleted) continue;
+
+		const int id1 = triangle._v[(ref._vertex + 1) % 3], id2 = triangle._v[(ref._vertex + 2) % 3];
+		if (id1 == v1 || id2 == v1)
+		{
+			deleted[k] = 1;
+			continue;
+		}
+
+		glm::dvec3 d1 = _vertices[id1]._position - position, d2 = _vertices[id2]._position - position;
+		d1 /= glm::length(d1);
+		d2 /= glm::length(d2);
+		if (std::abs(glm::dot(d1, d2)) > 0.999) return true;
+
+		glm::dvec3 normal = glm::cross(d1, d2);
+		normal /= glm::length(normal);
+		deleted[k] = 0;
+		if (glm::dot(normal, triangle._normal) < 0.2) return true;
+	}
+
+	return false;
+}
+
+void QuadricSimplifier::simplify(unsigned numFaces)
+{
+	const int numTriangles = static_cast<int>(_triangles.size()), targetCount = static_cast<int>(numFaces);
+	unsigned numDeletedTriangles = 0;
+
+	for (Triangle& triangle : _triangles) triangle._deleted = false;
+
+	for (unsigned iteration = 0; iteration < _maxIterations; ++iteration)
+	{
+		if (numTriangles - static_cast<int>(numDeletedTriangles) <= targetCount) break;
+
+		if (iteration % 5 == 0) this->updateMesh(iteration);
+
+		for (Triangle& triangle : _triangles) triangle._dirty = false;
+
+		// Edges below the threshold are collapsed
+		const double threshold = 0.000000001 * std::pow(static_cast<double>(iteration + 3), _aggressiveness);
+
+		for (size_t triangleIdx = 0; triangleIdx < _triangles.size(); ++triangleIdx)
+		{
+			const Triangle& triangle = _triangles[triangleIdx];
+			if (triangle._error[3] > threshold || triangle._deleted || triangle._dirty) continue;
+
+			for (int j = 0; j < 3; ++j)
+			{
+				if (!(triangle._error[j] < threshold)) continue;
+
+				const int i0 = triangle._v[j], i1 = triangle._v[(j + 1) % 3];
+				Vertex& v0 = _vertices[i0];
+				Vertex& v1 = _vertices[i1];
+				if (v0._border != v1._border) continue;
+
+				glm::dvec3 position;
+				this->calculateError(i0, i1, position);
+
+				_deleted0.resize(v0._refCount);
+				_deleted1.resize(v1._refCount);
+
+				if (this->flipped(position, i1, v0, _deleted0) || this->flipped(position, i0, v1, _deleted1)) continue;
+
+				v0._position = position;
+				v0._quadric = v1._quadric + v0._quadric;
+				const int refStart = static_cast<int>(_refs.size());
+
+				this->updateTriangles(i0, v0, _deleted0, numDeletedTriangles);
+				this->updateTriangles(i0, v1, _deleted1, numDeletedTriangles);
+
+				// Reuse the previous range of v0 whenever the new references fit within it
+				const int refCount = static_cast<int>(_refs.size()) - refStart;
+				if (refCount <= v0._refCount)
+				{
+					if (refCount) std::memmove(&_refs[v0._refStart], &_refs[refStart], refCount * sizeof(Ref));
+				}
+				else
+					v0._refStart = refStart;
+
+				v0._refCount = refCount;
+				break;
+			}
+
+			if (numTriangles - static_cast<int>(numDeletedTriangles) <= targetCount) break;
+		}
+	}
+
+	this->compactMesh();
+}
+
+void QuadricSimplifier::updateMesh(unsigned iteration)
+{
+	if (iteration > 0)
+	{
+		size_t dst = 0;
+		for (size_t triangleIdx = 0; triangleIdx < _triangles.size(); ++triangleIdx)
+			if (!_triangles[triangleIdx]._deleted) _triangles[dst++] = _triangles[triangleIdx];
+		_triangles.resize(dst);
+	}
+
+	// Reference lists
+	for (Vertex& vertex : _vertices) vertex._refStart = vertex._refCount = 0;
+
+	for (const Triangle& triangle : _triangles)
+		for (int i = 0; i < 3; ++i) ++_vertices[triangle._v[i]]._refCount;
+
+	int refStart = 0;
+	for (Vertex& vertex : _vertices)
+	{
+		vertex._refStart = refStart;
+		refStart += vertex._refCount;
+		vertex._refCount = 0;
+	}
+
+	_refs.resize(_triangles.size() * 3);
+	for (size_t triangleIdx = 0; triangleIdx < _triangles.size(); ++triangleIdx)
+	{
+		for (int i = 0; i < 3; ++i)
+		{
+			Vertex& vertex = _vertices[_triangles[triangleIdx]._v[i]];
+			_refs[vertex._refStart + vertex._refCount++] = Ref{ static_cast<int>(triangleIdx), i };
+		}
+	}
+
+	if (iteration > 0) return;
+
+	// Borders: vertices of an edge shared by a single triangle
+	for (Vertex& vertex : _vertices) vertex._border = false;
+
+	for (const Vertex& vertex : _vertices)
+	{
+		_neighbourCount.clear();
+		_neighbourId.clear();
+
+		for (int j = 0; j < vertex._refCount; ++j)
+		{
+			const Triangle& triangle = _triangles[_refs[vertex._refStart + j]._triangle];
+
+			for (int k = 0; k < 3; ++k)
+			{
+				size_t offset = 0;
+				while (offset < _neighbourId.size() && _neighbourId[offset] != triangle._v[k]) ++offset;
+
+				if (offset == _neighbourId.size())
+				{
+					_neighbourCount.push_back(1);
+					_neighbourId.push_back(triangle._v[k]);
+				}
+				else
+					++_neighbourCount[offset];
+			}
+		}
+
+		for (size_t j = 0; j < _neighbourCount.size(); ++j)
+			if (_neighbourCount[j] == 1) _vertices[_neighbourId[j]]._border = true;
+	}
+
+	// Quadrics and edge errors
+	for (Vertex& vertex : _vertices) vertex._quadric = Quadric::plane(.0, .0, .0, .0);
+
+	for (Triangle& triangle : _triangles)
+	{
+		const glm::dvec3 p0 = _vertices[triangle._v[0]]._position;
+		glm::dvec3 normal = glm::cross(_vertices[triangle._v[1]]._position - p0, _vertices[triangle._v[2]]._position - p0);
+		normal /= glm::length(normal);
+		triangle._normal = normal;
+
+		const Quadric quadric = Quadric::plane(normal.x, normal.y, normal.z, -glm::dot(normal, p0));
+		for (int i = 0; i < 3; ++i) _vertices[triangle._v[i]]._quadric = _vertices[triangle._v[i]]._quadric + quadric;
+	}
+
+	for (Triangle& triangle : _triangles)
+	{
+		glm::dvec3 position;
+		for (int i = 0; i < 3; ++i) triangle._error[i] = this->calculateError(triangle._v[i], triangle._v[(i + 1) % 3], position);
+		triangle._error[3] = std::min(triangle._error[0], std::min(triangle._error[1], triangle._error[2]));
+	}
+}
+
+void QuadricSimplifier::updateTriangles(int v0, const Vertex& vertex, const std::vector<char>& deleted, unsigned& numDeletedTriangles)
+{
+	glm::dvec3 position;
+
+	for (int k = 0; k < vertex._refCount; ++k)
+	{
+		const Ref ref = _refs[vertex._refStart + k];
+		Triangle& triangle = _triangles[ref._triangle];
+		if (triangle._deleted) continue;
+
+		if (deleted[k])
+		{
+			triangle._deleted = true;
+			++numDeletedTriangles;
+			continue;
+		}
+
+		triangle._v[ref._vertex] = v0;
+		triangle._dirty = true;
+		for (int i = 0; i < 3; ++i) triangle._error[i] = this->calculateError(triangle._v[i], triangle._v[(i + 1) % 3], position);
+		triangle._error[3] = std::min(triangle._error[0], std::min(triangle._error[1], triangle._error[2]));
+
+		_refs.push_back(ref);
+	}
+}
+
+/// [Quadric]
+
+QuadricSimplifier::Quadric QuadricSimplifier::Quadric::plane(double a, double b, double c, double d)
+{
+	return Quadric{ { a * a, a * b, a * c, a * d, b * b, b * c, b * d, c * c, c * d, d * d } };
+}
+
+double QuadricSimplifier::Quadric::det(int a11, int a12, int a13, int a21, int a22, int a23, int a31, int a32, int a33) const
+{
+	return _m[a11] * _m[a22] * _m[a33] + _m[a13] * _m[a21] * _m[a32] + _m[a12] * _m[a23] * _m[a31]
+		- _m[a13] * _m[a22] * _m[a31] - _m[a11] * _m[a23] * _m[a32] - _m[a12] * _m[a21] * _m[a33];
+}
+
+double QuadricSimplifier::Quadric::error(const glm::dvec3& point) const
+{
+	const double x = point.x, y = point.y, z = point.z;
+
+	return _m[0] * x * x + 2 * _m[1] * x * y + 2 * _m[2] * x * z + 2 * _m[3] * x + _m[4] * y * y
+		+ 2 * _m[5] * y * z + 2 * _m[6] * y + _m[7] * z * z + 2 * _m[8] * z + _m[9];
+}
+
+QuadricSimplifier::Quadric QuadricSimplifier::Quadric::operator+(const Quadric& quadric) const
+{
+	Quadric result;
+	for (int i = 0; i < 10; ++i) result._m[i] = _m[i] + quadric._m[i];
+
+	return result;
+}
@@ -0,0 +1,131 @@
+#pragma once
+
+/**
+*	@file QuadricSimplifier.h
+*	@authors Alfonso Lpez Ruiz (alr00048@red.ujaen.es)
+*	@date 19/10/2026
+*/
+
+#include "Graphics/Core/Model3D.h"
+
+/**
+*	@brief Quadric error decimation (Fast-Quadric-Mesh-Simplification) with no global state. Every instance owns its working buffers, 
+*	which are kept between calls, so that several meshes can be decimated concurrently by using an instance per thread.
+*/
+class QuadricSimplifier
+{
+protected:
+	/**
+	*	@brief Symmetric 4x4 matrix, stored as its upper triangle.
+	*/
+	struct Quadric
+	{
+		double _m[10];
+
+		/**
+		*	@brief Quadric of the plane ax + by + cz + d = 0.
+		*/
+		static Quadric plane(double a, double b, double c, double d);
+
+		/**
+		*	@brief Determinant of the 3x3 matrix given by the indices of its elements.
+		*/
+		double det(int a11, int a12, int a13, int a21, int a22, int a23, int a31, int a32, int a33) const;
+
+		/**
+		*	@brief Error of a point.
+		*/
+		double error(const glm::dvec3& point) const;
+
+		/**
+		*	@brief Element-wise sum.
+		*/
+		Quadric operator+(const Quadric& quadric) const;
+	};
+
+	struct Triangle
+	{
+		int				_v[3];									//!< Vertex indices
+		double			_error[4];								//!< Error of every edge and minimum error
+		bool			_deleted, _dirty;						//!< Collapse state
+		glm::dvec3		_normal;								//!< Normal at the beginning of the decimation
+	};
+
+	struct Vertex
+	{
+		glm::dvec3		_position;								//!< Current position
+		int				_refStart, _refCount;					//!< Range of references to triangles
+		Quadric			_quadric;								//!< Accumulated error quadric
+		bool			_border;								//!< Belongs to an open boundary
+	};
+
+	struct Ref
+	{
+		int				_triangle, _vertex;						//!< Triangle and corner within it
+	};
+
+protected:
+	double					_aggressiveness;					//!< Growth of the error threshold along iterations
+	unsigned				_maxIterations;						//!< Maximum number of collapse passes
+
+	std::vector<Triangle>	_triangles;							//!< Working triangles
+	std::vector<Vertex>		_vertices;							//!< Working vertices
+	std::vector<Ref>		_refs;								//!< Vertex to triangle references
+	std::vector<char>		_deleted0, _deleted1;				//!< Triangles removed by the collapse of an edge
+	std::vector<int>		_neighbourCount, _neighbourId;		//!< Border detection scratch
+
+protected:
+	/**
+	*	@brief Error of collapsing an edge and the optimal position of the resulting vertex.
+	*/
+	double calculateError(int v1, int v2, glm::dvec3& position) const;
+
+	/**
+	*	@brief Removes deleted triangles and vertices.
+	*/
+	void compactMesh();
+
+	/**
+	*	@brief Checks whether moving vertex v0 to the given position flips any of its triangles.
+	*/
+	bool flipped(const glm::dvec3& position, int v1, const Vertex& v0, std::vector<char>& deleted) const;
+
+	/**
+	*	@brief Builds the reference lists and, at the first iteration, the quadrics, borders and edge errors.
+	*/
+	void updateMesh(unsigned iteration);
+
+	/**
+	*	@brief Updates the triangles of a vertex after an edge collapse.
+	*/
+	void updateTriangles(int v0, const Vertex& vertex, const std::vector<char>& deleted, unsigned& numDeletedTriangles);
+
+	/**
+	*	@brief Runs the decimation over the working buffers.
+	*/
+	void simplify(unsigned numFaces);
+
+public:
+	/**
+	*	@brief Constructor. 
+	*	@param aggressiveness 5 to 8 are good values, lower ones are slower but yield better quality.
+	*/
+	QuadricSimplifier(double aggressiveness = 5.0, unsigned maxIterations = 100);
+
+	/**
+	*	@brief Destructor.
+	*/
+	virtual ~QuadricSimplifier();
+
+	/**
+	*	@brief Releases the working buffers.
+	*/
+	void releaseMemory();
+
+	/**
+	*	@brief Decimates a model component down to (approximately) the given number of faces.
+	*	@return False if the component already had fewer faces.
+	*/
+	bool simplify(Model3D::ModelComponent* modelComponent, unsigned numFaces);
+};
+
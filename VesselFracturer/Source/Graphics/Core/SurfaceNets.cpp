@@ -0,0 +1,181 @@
+#include "stdafx.h"
+#include "SurfaceNets.h"
+
+// [Public methods]
+
+SurfaceNets::SurfaceNets(const uvec3& numDivs) : MarchingCubesCPU(numDivs)
+{
+}
+
+SurfaceNets::~SurfaceNets()
+{
+}
+
+// [Protected methods]
+
+int SurfaceNets::CellLayer::find(int y, int z, uint16_t label) const
+{
+	const uvec2 cell = _cells[(y - _origin.x) * _width + (z - _origin.y)];
+	for (unsigned vertexIdx = cell.x; vertexIdx < cell.x + cell.y; ++vertexIdx)
+		if (_vertices[vertexIdx].first == label)
+			return int(_vertices[vertexIdx].second);
+
+	return -1;
+}
+
+void SurfaceNets::computeFaces(const PaddedGridView& grid, const std::vector<int>& labelSlot, unsigned x, const Chunk& chunk, const CellLayer& previousLayer, const CellLayer& currentLayer, std::vector<ChunkMesh>& meshes) const
+{
+	const uint16_t boundaryMask = uint16_t(1 << 15);
+
+	// Each edge belongs to the chunk of the cell whose lower corner is the lower voxel of the edge
+	for (unsigned y = chunk._first.y; y < chunk._last.y; ++y)
+	{
+		for (unsigned z = chunk._first.z; z < chunk._last.z; ++z)
+		{
+			const uint16_t value = grid.at(x, y, z), label = value & ~boundaryMask;
+
+			for (unsigned axis = 0; axis < 3; ++axis)
+			{
+				ivec3 neighbour = ivec3(x, y, z);
+				neighbour[axis] += 1;
+
+				const uint16_t neighbourValue = grid.at(neighbour.x, neighbour.y, neighbour.z), neighbourLabel = neighbourValue & ~boundaryMask;
+				if (label == neighbourLabel) continue;
+
+				// Cells around the edge (x, y, z) -> neighbour, given by their lower corner, in counter-clockwise order around +axis
+				const unsigned u = (axis + 1) % 3, w = (axis + 2) % 3;
+				const ivec2 offsets[4] = { ivec2(1, 1), ivec2(0, 1), ivec2(0, 0), ivec2(1, 0) };
+				ivec3 cells[4];
+
+				for (int cellIdx = 0; cellIdx < 4; ++cellIdx)
+				{
+					cells[cellIdx] = ivec3(x, y, z);
+					cells[cellIdx][u] -= offsets[cellIdx].x;
+					cells[cellIdx][w] -= offsets[cellIdx].y;
+				}
+
+				// Both sides of the edge are meshed, each one facing outwards from its own label
+				for (int side = 0; side < 2; ++side)
+				{
+					const uint16_t insideLabel = side == 0 ? label : neighbourLabel;
+					if (insideLabel >= labelSlot.size() || labelSlot[insideLabel] < 0) continue;
+
+					unsigned quad[4];
+					bool valid = true;
+
+					for (int cellIdx = 0; cellIdx < 4 && valid; ++cellIdx)
+					{
+						// Cells are indexed as in marching cubes, by their +x corner
+						const CellLayer& layer = unsigned(cells[cellIdx].x + 1) == x ? previousLayer : currentLayer;
+						const int vertexIdx = layer.find(cells[cellIdx].y, cells[cellIdx].z, insideLabel);
+
+						valid = vertexIdx >= 0;
+						quad[cellIdx] = unsigned(vertexIdx);
+					}
+
+					if (!valid) continue;
+
+					const unsigned isBoundary = unsigned(((side == 0 ? value : neighbourValue) & boundaryMask) != 0);
+					ChunkMesh& mesh = meshes[labelSlot[insideLabel]];
+
+					if (side == 0)
+					{
+						mesh._faces.push_back(uvec4(quad[0], quad[1], quad[2], isBoundary));
+						mesh._faces.push_back(uvec4(quad[0], quad[2], quad[3], isBoundary));
+					}
+					else
+					{
+						mesh._faces.push_back(uvec4(quad[0], quad[2], quad[1], isBoundary));
+						mesh._faces.push_back(uvec4(quad[0], quad[3], quad[2], isBoundary));
+					}
+				}
+			}
+		}
+	}
+}
+
+void SurfaceNets::computeVertices(const PaddedGridView& grid, const std::vector<int>& labelSlot, unsigned x, const Chunk& chunk, bool isSeam, CellLayer& layer, std::vector<ChunkMesh>& meshes) const
+{
+	const uint16_t boundaryMask = uint16_t(1 << 15);
+	uint16_t labels[8], cellLabels[8];
+
+	layer.clear();
+
+	// Cells before the chunk are also computed, since faces of the chunk may reach them
+	for (int y = std::max(layer._origin.x, 0); y < int(chunk._last.y); ++y)
+	{
+		for (int z = std::max(layer._origin.y, 0); z < int(chunk._last.z); ++z)
+		{
+			const ivec3 cell = ivec3(x, y, z);
+			bool uniform = true;
+
+			for (int cornerIdx = 0; cornerIdx < 8; ++cornerIdx)
+			{
+				const ivec3 corner = cell + NEIGHBOURS[cornerIdx];
+				labels[cornerIdx] = grid.at(corner.x, corner.y, corner.z) & ~boundaryMask;
+				uniform &= labels[cornerIdx] == labels[0];
+			}
+
+			if (uniform) continue;
+
+			unsigned numCellLabels = 0;
+			for (int cornerIdx = 0; cornerIdx < 8; ++cornerIdx)
+			{
+				const uint16_t label = labels[cornerIdx];
+				if (label >= labelSlot.size() || labelSlot[label] < 0 || std::find(cellLabels, cellLabels + numCellLabels, label) != cellLabels + numCellLabels)
+					continue;
+
+				cellLabels[numCellLabels++] = label;
+			}
+
+			const bool isSeamCell = isSeam || y == layer._origin.x || z == layer._origin.y || y == int(chunk._last.y) - 1 || z == int(chunk._last.z) - 1;
+			layer._cells[(y - layer._origin.x) * layer._width + (z - layer._origin.y)] = uvec2(layer._vertices.size(), numCellLabels);
+
+			for (unsigned labelIdx = 0; labelIdx < numCellLabels; ++labelIdx)
+			{
+				// Centroid of the edges crossed by the surface of this label
+				vec3 position = vec3(.0f);
+				unsigned numCrossings = 0;
+
+				for (int edgeIdx = 0; edgeIdx < 12; ++edgeIdx)
+				{
+					const ivec2 edge = EDGES[edgeIdx];
+					if ((labels[edge.x] == cellLabels[labelIdx]) != (labels[edge.y] == cellLabels[labelIdx]))
+					{
+						position += vec3(cell + NEIGHBOURS[edge.x] + cell + NEIGHBOURS[edge.y]) * .5f;
+						++numCrossings;
+					}
+				}
+
+				ChunkMesh& mesh = meshes[labelSlot[cellLabels[labelIdx]]];
+				const unsigned vertexIdx = unsigned(mesh._vertices.size());
+
+				mesh._vertices.push_back(vec4(position / float(numCrossings), .0f));
+				layer._vertices.push_back(std::make_pair(cellLabels[labelIdx], vertexIdx));
+
+				if (isSeamCell)
+					mesh._seamVertices.push_back(std::make_pair((uint64_t(x) * _numDivs.y + y) * _numDivs.z + z, vertexIdx));
+			}
+		}
+	}
+}
+
+void SurfaceNets::march(const PaddedGridView& grid, const std::vector<int>& labelSlot, const Chunk& chunk, std::vector<ChunkMesh>& meshes) const
+{
+	// Faces of the edges in plane x join cells of layers x and x + 1, hence the layer before the chunk is also computed (and stitched afterwards)
+	CellLayer previousLayer, currentLayer;
+	previousLayer._origin = ivec2(chunk._first.y, chunk._first.z) - 1;
+	previousLayer._width = chunk._last.z - chunk._first.z + 1;
+	previousLayer._cells.resize(size_t(chunk._last.y - chunk._first.y + 1) * previousLayer._width);
+	currentLayer = previousLayer;
+
+	this->computeVertices(grid, labelSlot, chunk._first.x - 1, chunk, true, previousLayer, meshes);
+
+	for (unsigned x = chunk._first.x; x < chunk._last.x; ++x)
+	{
+		this->computeVertices(grid, labelSlot, x, chunk, x == chunk._last.x - 1, currentLayer, meshes);
+		this->computeFaces(grid, labelSlot, x - 1, chunk, previousLayer, currentLayer, meshes);
+
+		std::swap(previousLayer, currentLayer);
+	}
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "Graphics/Core/MarchingCubesCPU.h"
+
+/**
+*	@file SurfaceNets.h
+*	@authors Alfonso Lpez Ruiz (alr00048@red.ujaen.es)
+*	@date 19/10/2026
+*/
+
+/**
+*	@brief Dual mesher (Surface Nets) over the label grid. Every cell crossed by the surface of a label gets a single vertex, placed at the 
+*	centroid of its crossing edges, and every crossing grid edge produces a quad joining the four cells around it, which is split into two 
+*	triangles. Chunks, stitching and smoothing are shared with the multi-label marching cubes.
+*/
+class SurfaceNets : public MarchingCubesCPU
+{
+protected:
+	/**
+	*	@brief Vertices of a yz-layer of cells within a chunk. Each cell keeps a contiguous range with one vertex per label.
+	*/
+	struct CellLayer
+	{
+		ivec2										_origin;		//!< First cell (y, z) of the layer
+		unsigned									_width;			//!< Number of cells along z
+		std::vector<uvec2>							_cells;			//!< First vertex and number of vertices per cell
+		std::vector<std::pair<uint16_t, unsigned>>	_vertices;		//!< Label and index within the chunk mesh of such label
+
+		void clear() { std::fill(_cells.begin(), _cells.end(), uvec2(0)); _vertices.clear(); }
+		int find(int y, int z, uint16_t label) const;
+	};
+
+protected:
+	/**
+	*	@brief Computes the vertices of a layer of cells.
+	*	@param isSeam Vertices of this layer are shared with a neighbour chunk.
+	*/
+	void computeVertices(const PaddedGridView& grid, const std::vector<int>& labelSlot, unsigned x, const Chunk& chunk, bool isSeam, CellLayer& layer, std::vector<ChunkMesh>& meshes) const;
+
+	/**
+	*	@brief Builds the faces of the grid edges whose lower voxel lies in a given yz-plane of the chunk.
+	*/
+	void computeFaces(const PaddedGridView& grid, const std::vector<int>& labelSlot, unsigned x, const Chunk& chunk, const CellLayer& previousLayer, const CellLayer& currentLayer, std::vector<ChunkMesh>& meshes) const;
+
+	/**
+	*	@brief Triangulates the cells of a chunk for every label with a slot.
+	*/
+	virtual void march(const PaddedGridView& grid, const std::vector<int>& labelSlot, const Chunk& chunk, std::vector<ChunkMesh>& meshes) const;
+
+public:
+	/**
+	*	@brief Constructor.
+	*	@param numDivs Dimensions of the regular grid.
+	*/
+	SurfaceNets(const uvec3& numDivs);
+
+	/**
+	*	@brief Destructor.
+	*/
+	virtual ~SurfaceNets();
+};
+
@@ -0,0 +1,197 @@
+#include "stdafx.h"
+#include "SurfaceVoxelizer.h"
+
+// [Static attributes]
+
+const unsigned SurfaceVoxelizer::BUCKET_HEIGHT = 4;
+const float SurfaceVoxelizer::BOX_EPSILON = 1e-4f;
+
+/// [Public methods]
+
+void SurfaceVoxelizer::compute(unsigned char* result) const
+{
+	const size_t numCells = size_t(_res.x) * _res.y * _res.z;
+	const int numBuckets = int(_bucketOffset.size()) - 1;
+
+	std::fill(result, result + numCells, UNKNOWN);
+
+	// Each bucket owns a range of Y layers, hence threads never write the same voxel
+#pragma omp parallel for schedule(dynamic)
+	for (int bucketIdx = 0; bucketIdx < numBuckets; ++bucketIdx)
+	{
+		this->voxelizeBucket(bucketIdx, result);
+	}
+
+	this->floodExterior(result);
+
+#pragma omp parallel for
+	for (int64_t cellIdx = 0; cellIdx < int64_t(numCells); ++cellIdx)
+	{
+		result[cellIdx] = result[cellIdx] != EXTERIOR;
+	}
+}
+
+void SurfaceVoxelizer::deleteModelResources()
+{
+	_bucketFaces.clear(); _bucketFaces.shrink_to_fit();
+	_bucketOffset.clear(); _bucketOffset.shrink_to_fit();
+	_faces.clear(); _faces.shrink_to_fit();
+	_vertices.clear(); _vertices.shrink_to_fit();
+}
+
+void SurfaceVoxelizer::initializeModel(const std::vector<Model3D::VertexGPUData>& meshVertices, const std::vector<Model3D::FaceGPUData>& meshFaces, const AABB& aabb)
+{
+	const vec3 cellSize = aabb.size() / vec3(_res);
+	const unsigned numBuckets = (_res.y + BUCKET_HEIGHT - 1) / BUCKET_HEIGHT;
+
+	_vertices.resize(meshVertices.size());
+	_faces.resize(meshFaces.size());
+
+#pragma omp parallel for
+	for (int vertexIdx = 0; vertexIdx < meshVertices.size(); ++vertexIdx)
+		_vertices[vertexIdx] = (meshVertices[vertexIdx]._position - aabb.min()) / cellSize;
+
+#pragma omp parallel for
+	for (int faceIdx = 0; faceIdx < meshFaces.size(); ++faceIdx)
+		_faces[faceIdx] = meshFaces[faceIdx]._vertices;
+
+	// Range of buckets overlapped by each face
+	std::vector<uvec2> faceBuckets(_faces.size());
+
+#pragma omp parallel for
+	for (int faceIdx = 0; faceIdx < _faces.size(); ++faceIdx)
+	{
+		const float minY = glm::min(_vertices[_faces[faceIdx].x].y, glm::min(_vertices[_faces[faceIdx].y].y, _vertices[_faces[faceIdx].z].y));
+		const float maxY = glm::max(_vertices[_faces[faceIdx].x].y, glm::max(_vertices[_faces[faceIdx].y].y, _vertices[_faces[faceIdx].z].y));
+		const int minLayer = glm::clamp(int(glm::floor(minY - .5f - BOX_EPSILON)), 0, _res.y - 1);
+		const int maxLayer = glm::clamp(int(glm::floor(maxY + .5f + BOX_EPSILON)), 0, _res.y - 1);
+
+		faceBuckets[faceIdx] = uvec2(minLayer / BUCKET_HEIGHT, maxLayer / BUCKET_HEIGHT);
+	}
+
+	// CSR layout of faces per bucket
+	_bucketOffset = std::vector<unsigned>(numBuckets + 1, 0);
+	for (const uvec2& bucketRange : faceBuckets)
+		for (unsigned bucketIdx = bucketRange.x; bucketIdx <= bucketRange.y; ++bucketIdx)
+			++_bucketOffset[bucketIdx + 1];
+
+	std::partial_sum(_bucketOffset.begin(), _bucketOffset.end(), _bucketOffset.begin());
+
+	std::vector<unsigned> bucketCursor(_bucketOffset.begin(), _bucketOffset.end() - 1);
+	_bucketFaces.resize(_bucketOffset.back());
+
+	for (unsigned faceIdx = 0; faceIdx < faceBuckets.size(); ++faceIdx)
+		for (unsigned bucketIdx = faceBuckets[faceIdx].x; bucketIdx <= faceBuckets[faceIdx].y; ++bucketIdx)
+			_bucketFaces[bucketCursor[bucketIdx]++] = faceIdx;
+}
+
+/// [Protected methods]
+
+void SurfaceVoxelizer::floodExterior(unsigned char* result) const
+{
+	struct Seed { int _x, _y, _z; };
+	std::vector<Seed> seeds;
+
+	// Pushes the first unknown voxel of every run within [xBegin, xEnd] of a row
+	auto pushRuns = [&](int xBegin, int xEnd, int y, int z) {
+		if (y < 0 || y >= _res.y || z < 0 || z >= _res.z) return;
+
+		const unsigned char* row = result + this->getIndex(0, y, z);
+		for (int x = xBegin; x <= xEnd; ++x)
+			if (row[x] == UNKNOWN && (x == xBegin || row[x - 1] != UNKNOWN))
+				seeds.push_back(Seed{ x, y, z });
+	};
+
+	for (int y = 0; y < _res.y; ++y)
+	{
+		for (int z = 0; z < _res.z; ++z)
+		{
+			if (y == 0 || y == _res.y - 1 || z == 0 || z == _res.z - 1)
+			{
+				pushRuns(0, _res.x - 1, y, z);
+			}
+			else
+			{
+				pushRuns(0, 0, y, z);
+				pushRuns(_res.x - 1, _res.x - 1, y, z);
+			}
+		}
+	}
+
+	while (!seeds.empty())
+	{
+		const Seed seed = seeds.back();
+		seeds.pop_back();
+
+		unsigned char* row = result + this->getIndex(0, seed._y, seed._z);
+		if (row[seed._x] != UNKNOWN) continue;
+
+		int xBegin = seed._x, xEnd = seed._x;
+		while (xBegin > 0 && row[xBegin - 1] == UNKNOWN) --xBegin;
+		while (xEnd < _res.x - 1 && row[xEnd + 1] == UNKNOWN) ++xEnd;
+
+		std::fill(row + xBegin, row + xEnd + 1, EXTERIOR);
+
+		pushRuns(xBegin, xEnd, seed._y - 1, seed._z);
+		pushRuns(xBegin, xEnd, seed._y + 1, seed._z);
+		pushRuns(xBegin, xEnd, seed._y, seed._z - 1);
+		pushRuns(xBegin, xEnd, seed._y, seed._z + 1);
+	}
+}
+
+bool SurfaceVoxelizer::overlaps(const vec3& boxCenter, float boxHalfSize, const vec3& v1, const vec3& v2, const vec3& v3)
+{
+	const vec3 a = v1 - boxCenter, b = v2 - boxCenter, c = v3 - boxCenter;
+
+	auto separated = [&](const vec3& axis) {
+		const float pA = glm::dot(axis, a), pB = glm::dot(axis, b), pC = glm::dot(axis, c);
+		const float radius = boxHalfSize * (std::abs(axis.x) + std::abs(axis.y) + std::abs(axis.z));
+
+		return glm::min(pA, glm::min(pB, pC)) > radius || glm::max(pA, glm::max(pB, pC)) < -radius;
+	};
+
+	// Box normals
+	if (separated(vec3(1.0f, .0f, .0f)) || separated(vec3(.0f, 1.0f, .0f)) || separated(vec3(.0f, .0f, 1.0f))) return false;
+
+	// Triangle normal
+	const vec3 edges[3] = { b - a, c - b, a - c };
+	if (separated(glm::cross(edges[0], edges[1]))) return false;
+
+	// Cross products of box and triangle edges
+	for (const vec3& edge : edges)
+	{
+		if (separated(vec3(.0f, -edge.z, edge.y)) || separated(vec3(edge.z, .0f, -edge.x)) || separated(vec3(-edge.y, edge.x, .0f))) 
+			return false;
+	}
+
+	return true;
+}
+
+void SurfaceVoxelizer::voxelizeBucket(unsigned bucketIdx, unsigned char* result) const
+{
+	const int bucketMinY = bucketIdx * BUCKET_HEIGHT, bucketMaxY = glm::min(int(bucketMinY + BUCKET_HEIGHT), _res.y) - 1;
+	const float boxHalfSize = .5f + BOX_EPSILON;
+
+	for (unsigned faceIdx = _bucketOffset[bucketIdx]; faceIdx < _bucketOffset[bucketIdx + 1]; ++faceIdx)
+	{
+		const uvec3 face = _faces[_bucketFaces[faceIdx]];
+		const vec3 &v1 = _vertices[face.x], &v2 = _vertices[face.y], &v3 = _vertices[face.z];
+
+		const ivec3 minVoxel = glm::max(ivec3(glm::floor(glm::min(v1, glm::min(v2, v3)) - boxHalfSize)), ivec3(0, bucketMinY, 0));
+		const ivec3 maxVoxel = glm::min(ivec3(glm::floor(glm::max(v1, glm::max(v2, v3)) + boxHalfSize)), ivec3(_res.x - 1, bucketMaxY, _res.z - 1));
+
+		for (int y = minVoxel.y; y <= maxVoxel.y; ++y)
+		{
+			for (int z = minVoxel.z; z <= maxVoxel.z; ++z)
+			{
+				unsigned char* row = result + this->getIndex(0, y, z);
+
+				for (int x = minVoxel.x; x <= maxVoxel.x; ++x)
+				{
+					if (row[x] != SURFACE && SurfaceVoxelizer::overlaps(vec3(x, y, z) + .5f, boxHalfSize, v1, v2, v3))
+						row[x] = SURFACE;
+				}
+			}
+		}
+	}
+}
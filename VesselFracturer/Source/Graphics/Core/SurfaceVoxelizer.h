@@ -0,0 +1,78 @@
+#pragma once
+
+#include "Geometry/3D/AABB.h"
+#include "Graphics/Core/Model3D.h"
+
+/**
+*	@file SurfaceVoxelizer.h
+*	@authors Alfonso Lpez Ruiz (alr00048@red.ujaen.es)
+*	@date 19/10/2026
+*/
+
+/**
+*	@brief Solid voxelizer for non-watertight meshes. Every voxel touched by a triangle is marked (triangle/box separating axis test), 
+*	then the exterior is flooded from the grid border and every voxel not reached is considered solid. Holes smaller than a voxel do not leak.
+*/
+class SurfaceVoxelizer
+{
+protected:
+	static const unsigned	BUCKET_HEIGHT;					//!< Number of Y layers of each bucket of triangles
+	static const float		BOX_EPSILON;					//!< Enlargement of voxels to keep the surface closed despite rounding errors
+
+	enum VoxelState : unsigned char { UNKNOWN = 0, SURFACE = 1, EXTERIOR = 2 };
+
+protected:
+	std::vector<unsigned>	_bucketOffset;				//!< CSR offsets of each bucket into _bucketFaces
+	std::vector<unsigned>	_bucketFaces;				//!< Faces overlapping each bucket
+	std::vector<uvec3>		_faces;						//!< Vertex indices of each face
+	ivec3					_res;						//!< Voxelization resolution
+	std::vector<vec3>		_vertices;					//!< Vertices in grid space, i.e. voxel (x, y, z) spans [x, x + 1] x [y, y + 1] x [z, z + 1]
+
+protected:
+	/**
+	*	@brief Flood fills the exterior voxels reachable from the grid border (6-connectivity), using a scanline strategy along X.
+	*/
+	void floodExterior(unsigned char* result) const;
+
+	/**
+	*	@return Index of a voxel in the output buffer.
+	*/
+	size_t getIndex(int x, int y, int z) const { return (size_t(y) * _res.z + z) * _res.x + x; }
+
+	/**
+	*	@return True if the triangle overlaps the box centered at boxCenter, with half size boxHalfSize.
+	*/
+	static bool overlaps(const vec3& boxCenter, float boxHalfSize, const vec3& v1, const vec3& v2, const vec3& v3);
+
+	/**
+	*	@brief Marks the voxels touched by the faces of a bucket. 
+	*/
+	void voxelizeBucket(unsigned bucketIdx, unsigned char* result) const;
+
+public:
+	/**
+	*	@brief Constructor.
+	*/
+	SurfaceVoxelizer() {}
+
+	/**
+	*	@brief Initializes the voxelizer for the given resolution.
+	*/
+	void initialize(const ivec3& res) { _res = res; }
+
+	/**
+	*	@brief Transforms the model into grid space and distributes its faces into buckets of Y layers.
+	*/
+	void initializeModel(const std::vector<Model3D::VertexGPUData>& meshVertices, const std::vector<Model3D::FaceGPUData>& meshFaces, const AABB& aabb);
+
+	/**
+	*	@brief Voxelizes the model into result, which must hold res.x * res.y * res.z elements with layout y * X * Z + z * X + x.
+	*/
+	void compute(unsigned char* result) const;
+
+	/**
+	*	@brief Releases the model data.
+	*/
+	void deleteModelResources();
+};
+
@@ -261,7 +261,7 @@ void Tetravoxelizer::deleteModelResources() {
 	glDeleteVertexArrays(1, &VAO);
 }
 
-void Tetravoxelizer::compute(std::vector<unsigned char>& result)
+void Tetravoxelizer::compute(unsigned char* result)
 {
 	// Activate render to texture
 	glBindFramebuffer(GL_FRAMEBUFFER, resultFBO);
@@ -98,7 +98,7 @@ public:
 	void initializeModel(const std::vector<Model3D::VertexGPUData>& meshVertices, const std::vector<Model3D::FaceGPUData>& meshFaces, const AABB& aabb);
 
 	/* Perform voxelization */
-	void compute(std::vector<unsigned char>& result);
+	void compute(unsigned char* result);
 
 	/** Delete model resources */
 	void deleteModelResources();
@@ -0,0 +1,180 @@
+#include "stdafx.h"
+#include "TetravoxelizerCPU.h"
+
+// [Static attributes]
+
+const int TetravoxelizerCPU::SUBPIXEL_BITS = 8;
+
+/// [Public methods]
+
+void TetravoxelizerCPU::compute(unsigned char* result) const
+{
+	const size_t sliceSize = size_t(_res.x) * _res.z;
+
+#pragma omp parallel for schedule(dynamic)
+	for (int sliceIdx = 0; sliceIdx < _res.y; ++sliceIdx)
+	{
+		unsigned char* slice = result + sliceSize * sliceIdx;
+
+		std::fill(slice, slice + sliceSize, 0);
+		this->voxelizeSlice(sliceIdx, slice);
+	}
+}
+
+void TetravoxelizerCPU::deleteModelResources()
+{
+	_tetrahedra.clear();
+	_tetrahedra.shrink_to_fit();
+}
+
+void TetravoxelizerCPU::initialize(const ivec3& res)
+{
+	_res = res;
+
+	// Same accumulation as the GPU version, so that every slice is located at the very same height
+	float ySlice = -1.0f;
+	const float yStep = 2.0f / res.y;
+
+	_sliceY.resize(res.y);
+	for (int sliceIdx = 0; sliceIdx < res.y; ++sliceIdx)
+	{
+		_sliceY[sliceIdx] = ySlice;
+		ySlice += yStep;
+	}
+}
+
+void TetravoxelizerCPU::initializeModel(const std::vector<Model3D::VertexGPUData>& meshVertices, const std::vector<Model3D::FaceGPUData>& meshFaces, const AABB& aabb)
+{
+	vec3 centroid = vec3(.0f);
+
+	for (int vertexIdx = 0; vertexIdx < meshVertices.size(); ++vertexIdx)
+		centroid += meshVertices[vertexIdx]._position;
+
+	centroid /= meshVertices.size();
+
+	const vec3 maxDimBBox = aabb.size();
+	const vec3 centerBBox = .5f * (aabb.min() + aabb.max());
+	centroid = 2.0f * (centroid - centerBBox) / maxDimBBox;
+
+	_tetrahedra.resize(meshFaces.size());
+
+#pragma omp parallel for
+	for (int faceIdx = 0; faceIdx < meshFaces.size(); ++faceIdx)
+	{
+		vec3* vertices = _tetrahedra[faceIdx]._vertex;
+		vertices[0] = 2.0f * (meshVertices[meshFaces[faceIdx]._vertices.x]._position - centerBBox) / maxDimBBox;
+		vertices[1] = 2.0f * (meshVertices[meshFaces[faceIdx]._vertices.y]._position - centerBBox) / maxDimBBox;
+		vertices[2] = 2.0f * (meshVertices[meshFaces[faceIdx]._vertices.z]._position - centerBBox) / maxDimBBox;
+		vertices[3] = centroid;
+
+		// Sorting network for 4 elements
+		if (vertices[0].y > vertices[1].y) std::swap(vertices[0], vertices[1]);
+		if (vertices[2].y > vertices[3].y) std::swap(vertices[2], vertices[3]);
+		if (vertices[0].y > vertices[2].y) std::swap(vertices[0], vertices[2]);
+		if (vertices[1].y > vertices[3].y) std::swap(vertices[1], vertices[3]);
+		if (vertices[1].y > vertices[2].y) std::swap(vertices[1], vertices[2]);
+	}
+
+#ifdef FILTER_TETRAHEDRA_BY_Y
+	std::sort(_tetrahedra.begin(), _tetrahedra.end(), [](const Tetrahedron& a, const Tetrahedron& b) {
+		return a._vertex[3].y < b._vertex[3].y;
+		});
+#endif
+}
+
+/// [Protected methods]
+
+void TetravoxelizerCPU::rasterizeTriangle(const vec2& v1, const vec2& v2, const vec2& v3, unsigned char* slice) const
+{
+	const float subpixels = float(1 << SUBPIXEL_BITS);
+	const int64_t halfPixel = int64_t(1) << (SUBPIXEL_BITS - 1);
+
+	// Viewport transform and snapping to the subpixel grid
+	const vec2 vertices[3] = { v1, v2, v3 };
+	int64_t x[3], y[3];
+
+	for (int vertexIdx = 0; vertexIdx < 3; ++vertexIdx)
+	{
+		x[vertexIdx] = std::llround((vertices[vertexIdx].x + 1.0f) * .5f * _res.x * subpixels);
+		y[vertexIdx] = std::llround((vertices[vertexIdx].y + 1.0f) * .5f * _res.z * subpixels);
+	}
+
+	const int64_t area = (x[1] - x[0]) * (y[2] - y[0]) - (y[1] - y[0]) * (x[2] - x[0]);
+	if (area == 0) return;
+	if (area < 0)															// Counter-clockwise, as there is no face culling in the GPU version
+	{
+		std::swap(x[1], x[2]);
+		std::swap(y[1], y[2]);
+	}
+
+	// Bounding box of covered pixel centers
+	const int64_t minX = std::max(int64_t(0), (std::min(x[0], std::min(x[1], x[2])) - halfPixel) >> SUBPIXEL_BITS);
+	const int64_t maxX = std::min(int64_t(_res.x - 1), (std::max(x[0], std::max(x[1], x[2])) - halfPixel) >> SUBPIXEL_BITS);
+	const int64_t minY = std::max(int64_t(0), (std::min(y[0], std::min(y[1], y[2])) - halfPixel) >> SUBPIXEL_BITS);
+	const int64_t maxY = std::min(int64_t(_res.z - 1), (std::max(y[0], std::max(y[1], y[2])) - halfPixel) >> SUBPIXEL_BITS);
+	if (minX > maxX || minY > maxY) return;
+
+	// Edge functions evaluated at the first pixel center, biased so that pixels on edges which are not top-left are excluded
+	const int64_t centerX = (minX << SUBPIXEL_BITS) + halfPixel, centerY = (minY << SUBPIXEL_BITS) + halfPixel;
+	int64_t rowValue[3], stepX[3], stepY[3];
+
+	for (int edgeIdx = 0; edgeIdx < 3; ++edgeIdx)
+	{
+		const int nextIdx = (edgeIdx + 1) % 3;
+		const int64_t deltaX = x[nextIdx] - x[edgeIdx], deltaY = y[nextIdx] - y[edgeIdx];
+		const bool topLeft = deltaY < 0 || (deltaY == 0 && deltaX < 0);
+
+		stepX[edgeIdx] = -deltaY * (int64_t(1) << SUBPIXEL_BITS);
+		stepY[edgeIdx] = deltaX * (int64_t(1) << SUBPIXEL_BITS);
+		rowValue[edgeIdx] = deltaX * (centerY - y[edgeIdx]) - deltaY * (centerX - x[edgeIdx]) - (topLeft ? 0 : 1);
+	}
+
+	for (int64_t pixelY = minY; pixelY <= maxY; ++pixelY)
+	{
+		int64_t value[3] = { rowValue[0], rowValue[1], rowValue[2] };
+		unsigned char* row = slice + pixelY * _res.x;
+
+		for (int64_t pixelX = minX; pixelX <= maxX; ++pixelX)
+		{
+			if ((value[0] | value[1] | value[2]) >= 0) row[pixelX] ^= 1;
+
+			value[0] += stepX[0]; value[1] += stepX[1]; value[2] += stepX[2];
+		}
+
+		rowValue[0] += stepY[0]; rowValue[1] += stepY[1]; rowValue[2] += stepY[2];
+	}
+}
+
+void TetravoxelizerCPU::voxelizeSlice(int sliceIdx, unsigned char* slice) const
+{
+	const float ySlice = _sliceY[sliceIdx];
+	auto interpolate = [ySlice](const vec3& a, const vec3& b) {
+		const vec3 point = glm::mix(a, b, (ySlice - a.y) / (b.y - a.y));
+		return vec2(point.x, point.z);
+	};
+
+	auto tetrahedron = _tetrahedra.begin();
+
+#ifdef FILTER_TETRAHEDRA_BY_Y
+	// Tetrahedra whose highest vertex lies below the slice are discarded
+	tetrahedron = std::lower_bound(_tetrahedra.begin(), _tetrahedra.end(), ySlice, [](const Tetrahedron& tetrahedron, float ySlice) {
+		return tetrahedron._vertex[3].y < ySlice;
+		});
+#endif
+
+	for (; tetrahedron != _tetrahedra.end(); ++tetrahedron)
+	{
+		const vec3 *A = &tetrahedron->_vertex[0], *B = &tetrahedron->_vertex[1], *C = &tetrahedron->_vertex[2], *D = &tetrahedron->_vertex[3];
+		if (!(A->y < ySlice && ySlice <= D->y)) continue;
+
+		const vec2 v0 = interpolate(*A, *D);
+		const vec2 v1 = ySlice <= B->y ? interpolate(*A, *B) : interpolate(*B, *D);
+		const vec2 v2 = ySlice <= C->y ? interpolate(*A, *C) : interpolate(*C, *D);
+
+		this->rasterizeTriangle(v0, v1, v2, slice);
+
+		// Extra triangle between vertices B and C
+		if (B->y < ySlice && ySlice <= C->y)
+			this->rasterizeTriangle(interpolate(*B, *C), v2, v1, slice);
+	}
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "Geometry/3D/AABB.h"
+#include "Graphics/Core/Model3D.h"
+#include "Graphics/Core/Tetravoxelizer.h"
+
+/**
+*	@file TetravoxelizerCPU.h
+*	@authors Alfonso Lpez Ruiz (alr00048@red.ujaen.es)
+*	@date 19/10/2026
+*/
+
+/**
+*	@brief Multithreaded CPU port of Tetravoxelizer (simplicial coverings), so that meshes can be voxelized without an OpenGL context.
+*	Each Y slice is rasterized by a single thread, XOR-ing the triangles which result from cutting every tetrahedron with the slice plane.
+*	Rasterization follows the GL rules (pixel centers, 8-bit subpixel snapping and a top-left fill convention), so that the output 
+*	has the same layout and content as the GPU version.
+*/
+class TetravoxelizerCPU
+{
+protected:
+	static const int SUBPIXEL_BITS;						//!< Precision of the snapped window coordinates
+
+	/**
+	*	@brief Tetrahedron whose vertices are sorted by their Y coordinate.
+	*/
+	struct Tetrahedron
+	{
+		vec3		_vertex[4];
+	};
+
+protected:
+	ivec3						_res;					//!< Voxelization resolution
+	std::vector<float>			_sliceY;				//!< Height of each slice in NDC, accumulated as in the GPU version
+	std::vector<Tetrahedron>	_tetrahedra;			//!< Tetrahedra sorted by their highest Y coordinate
+
+protected:
+	/**
+	*	@brief Rasterizes a triangle (in NDC, XZ plane) into the slice by toggling the covered pixels.
+	*/
+	void rasterizeTriangle(const vec2& v1, const vec2& v2, const vec2& v3, unsigned char* slice) const;
+
+	/**
+	*	@brief Computes the polygon given by the intersection of the tetrahedra with a slice and rasterizes it.
+	*/
+	void voxelizeSlice(int sliceIdx, unsigned char* slice) const;
+
+public:
+	/**
+	*	@brief Constructor.
+	*/
+	TetravoxelizerCPU() {}
+
+	/**
+	*	@brief Initializes the voxelizer for the given resolution.
+	*/
+	void initialize(const ivec3& res);
+
+	/**
+	*	@brief Builds the tetrahedra of the model, one for each face plus the mesh centroid.
+	*/
+	void initializeModel(const std::vector<Model3D::VertexGPUData>& meshVertices, const std::vector<Model3D::FaceGPUData>& meshFaces, const AABB& aabb);
+
+	/**
+	*	@brief Voxelizes the model into result, which must hold res.x * res.y * res.z elements with layout y * X * Z + z * X + x.
+	*/
+	void compute(unsigned char* result) const;
+
+	/**
+	*	@brief Releases the tetrahedra of the model.
+	*/
+	void deleteModelResources();
+};
+
@@ -0,0 +1,42 @@
+#include "stdafx.h"
+#include "WindingNumberVoxelizer.h"
+
+// [Static attributes]
+
+const unsigned WindingNumberVoxelizer::BATCH_SIZE = 32;
+
+/// [Public methods]
+
+void WindingNumberVoxelizer::compute(unsigned char* result) const
+{
+	const vec3 cellSize = _aabb.size() / vec3(_res);
+	const int numBatchesColumn = (_res.y + BATCH_SIZE - 1) / BATCH_SIZE;
+	const int64_t numBatches = int64_t(_res.x) * _res.z * numBatchesColumn;
+
+#pragma omp parallel
+	{
+		std::vector<vec3> points(BATCH_SIZE);
+		std::vector<float> windingNumber(BATCH_SIZE);
+
+#pragma omp for schedule(dynamic, 64)
+		for (int64_t batchIdx = 0; batchIdx < numBatches; ++batchIdx)
+		{
+			const int x = int(batchIdx % _res.x), z = int((batchIdx / _res.x) % _res.z), firstY = int(batchIdx / (int64_t(_res.x) * _res.z)) * BATCH_SIZE;
+			const unsigned numPoints = std::min(unsigned(_res.y - firstY), BATCH_SIZE);
+
+			for (unsigned pointIdx = 0; pointIdx < numPoints; ++pointIdx)
+				points[pointIdx] = _aabb.min() + cellSize * (vec3(x, firstY + pointIdx, z) + .5f);
+
+			_bvh->windingNumbers(points.data(), numPoints, windingNumber.data());
+
+			for (unsigned pointIdx = 0; pointIdx < numPoints; ++pointIdx)
+				result[(size_t(firstY + pointIdx) * _res.z + z) * _res.x + x] = std::abs(windingNumber[pointIdx]) > .5f;			// Inverted meshes are also accepted
+		}
+	}
+}
+
+void WindingNumberVoxelizer::initializeModel(const std::vector<Model3D::VertexGPUData>& meshVertices, const std::vector<Model3D::FaceGPUData>& meshFaces, const AABB& aabb)
+{
+	_aabb = aabb;
+	_bvh = std::make_unique<TriangleBVH>(meshVertices, meshFaces);
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "DataStructures/TriangleBVH.h"
+#include "Geometry/3D/AABB.h"
+#include "Graphics/Core/Model3D.h"
+
+/**
+*	@file WindingNumberVoxelizer.h
+*	@authors Alfonso Lpez Ruiz (alr00048@red.ujaen.es)
+*	@date 19/10/2026
+*/
+
+/**
+*	@brief Robust solid voxelizer for badly broken meshes. A voxel is solid if the generalized winding number at its center is greater 
+*	than 0.5 (in absolute value), which is evaluated with a hierarchical (fast winding number) traversal of a triangle BVH. Voxel columns are split into 
+*	batches of consecutive voxels which share the traversal.
+*/
+class WindingNumberVoxelizer
+{
+protected:
+	static const unsigned			BATCH_SIZE;			//!< Number of consecutive voxels of a column evaluated together
+
+protected:
+	AABB							_aabb;				//!< Voxelized space
+	std::unique_ptr<TriangleBVH>	_bvh;				//!< Hierarchy of model triangles
+	ivec3							_res;				//!< Voxelization resolution
+
+public:
+	/**
+	*	@brief Constructor.
+	*/
+	WindingNumberVoxelizer() {}
+
+	/**
+	*	@brief Initializes the voxelizer for the given resolution.
+	*/
+	void initialize(const ivec3& res) { _res = res; }
+
+	/**
+	*	@brief Builds the BVH of the model.
+	*/
+	void initializeModel(const std::vector<Model3D::VertexGPUData>& meshVertices, const std::vector<Model3D::FaceGPUData>& meshFaces, const AABB& aabb);
+
+	/**
+	*	@brief Voxelizes the model into result, which must hold res.x * res.y * res.z elements with layout y * X * Z + z * X + x.
+	*/
+	void compute(unsigned char* result) const;
+
+	/**
+	*	@brief Releases the BVH of the model.
+	*/
+	void deleteModelResources() { _bvh.reset(); }
+};
+
@@ -2,6 +2,13 @@
 
 #include "stdafx.h"
 
+#include <atomic>
+#ifdef _WIN32
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+
 /**
 *	@brief Set of useful operations for file management.
 */
@@ -12,6 +19,12 @@ namespace FileManagement
 	*/
 	void clearTokens(std::vector<std::string>& stringTokens, std::vector<float>& floatTokens);
 
+	/**
+	*	@return Suffix which is unique among every running process (process id) and every call within this process (counter), so that 
+	*	temporary files of concurrent runs never collide.
+	*/
+	std::string getUniqueSuffix();
+
 	/**
 	*	@brief Searchs for files in a given folder, with a given extension.
 	*/
@@ -24,6 +37,19 @@ inline void FileManagement::clearTokens(std::vector<std::string>& stringTokens,
 	floatTokens.clear();
 }
 
+inline std::string FileManagement::getUniqueSuffix()
+{
+	static std::atomic<uint64_t> counter(0);
+
+#ifdef _WIN32
+	const int processId = _getpid();
+#else
+	const int processId = static_cast<int>(getpid());
+#endif
+
+	return std::to_string(processId) + "_" + std::to_string(counter++);
+}
+
 inline void FileManagement::searchFiles(const std::string& folder, const std::string& extension, std::vector<std::string>& files)
 {
 	for (auto& assetFile : std::filesystem::recursive_directory_iterator(folder))
@@ -0,0 +1,34 @@
+#pragma once
+
+/**
+*	@file HashUtilities.h
+*	@authors Alfonso Lpez Ruiz (alr00048@red.ujaen.es)
+*	@date 19/10/2026
+*/
+
+/**
+*	@brief Non-cryptographic hashes used to identify cached content.
+*/
+namespace HashUtilities
+{
+	const uint64_t FNV_OFFSET_BASIS = 14695981039346656037ull;		//!< Initial value of an FNV-1a hash
+	const uint64_t FNV_PRIME = 1099511628211ull;					//!< Multiplier of every FNV-1a step
+
+	/**
+	*	@return Hash of the given bytes, combined with a previous one (FNV-1a).
+	*/
+	uint64_t fnv1a(const void* data, size_t size, uint64_t seed = FNV_OFFSET_BASIS);
+}
+
+inline uint64_t HashUtilities::fnv1a(const void* data, size_t size, uint64_t seed)
+{
+	const unsigned char* bytes = static_cast<const unsigned char*>(data);
+
+	for (size_t byteIdx = 0; byteIdx < size; ++byteIdx)
+	{
+		seed ^= bytes[byteIdx];
+		seed *= FNV_PRIME;
+	}
+
+	return seed;
+}
@@ -0,0 +1,203 @@
+#include "stdafx.h"
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/// [Public methods]
+
+MappedFile::MappedFile() :
+	_accessMode(READ_ONLY), _data(nullptr), _size(0),
+#ifdef _WIN32
+	_fileHandle(INVALID_HANDLE_VALUE), _mappingHandle(nullptr)
+#else
+	_fileDescriptor(-1)
+#endif
+{
+}
+
+MappedFile::~MappedFile()
+{
+	this->close();
+}
+
+void MappedFile::close()
+{
+#ifdef _WIN32
+	if (_data) UnmapViewOfFile(_data);
+	if (_mappingHandle) CloseHandle(_mappingHandle);
+	if (_fileHandle != INVALID_HANDLE_VALUE) CloseHandle(_fileHandle);
+
+	_fileHandle = INVALID_HANDLE_VALUE;
+	_mappingHandle = nullptr;
+#else
+	if (_data) munmap(_data, _size);
+	if (_fileDescriptor >= 0) ::close(_fileDescriptor);
+
+	_fileDescriptor = -1;
+#endif
+
+	_data = nullptr;
+	_size = 0;
+}
+
+bool MappedFile::create(const std::string& filename, size_t size, bool temporary)
+{
+	this->close();
+
+	_accessMode = READ_WRITE;
+	_filename = filename;
+	_size = size;
+
+#ifdef _WIN32
+	_fileHandle = CreateFileA(
+		filename.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | (temporary ? FILE_SHARE_DELETE : 0), nullptr, CREATE_ALWAYS,
+		FILE_ATTRIBUTE_NORMAL | (temporary ? FILE_ATTRIBUTE_TEMPORARY | FILE_FLAG_DELETE_ON_CLOSE : 0), nullptr);
+	if (_fileHandle == INVALID_HANDLE_VALUE) return false;
+#else
+	_fileDescriptor = ::open(filename.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+	if (_fileDescriptor < 0) return false;
+
+	if (ftruncate(_fileDescriptor, static_cast<off_t>(size)) != 0)
+	{
+		this->close();
+		return false;
+	}
+
+	if (temporary) unlink(filename.c_str());
+#endif
+
+	return this->map();
+}
+
+void MappedFile::evict(size_t offset, size_t size)
+{
+	char* begin;
+	size_t length;
+	if (!this->getPageRange(offset, size, begin, length)) return;
+
+#ifdef _WIN32
+	if (_accessMode == READ_WRITE) FlushViewOfFile(begin, length);
+	VirtualUnlock(begin, length);										// Removes unlocked pages from the working set
+#else
+	madvise(begin, length, MADV_DONTNEED);								// Shared mapping: dirty pages are kept in the page cache
+#endif
+}
+
+void MappedFile::flush(size_t offset, size_t size)
+{
+	char* begin;
+	size_t length;
+	if (_accessMode != READ_WRITE || !this->getPageRange(offset, size, begin, length)) return;
+
+#ifdef _WIN32
+	FlushViewOfFile(begin, length);
+#else
+	msync(begin, length, MS_ASYNC);
+#endif
+}
+
+size_t MappedFile::getPageSize()
+{
+#ifdef _WIN32
+	SYSTEM_INFO systemInfo;
+	GetSystemInfo(&systemInfo);
+
+	return systemInfo.dwPageSize;
+#else
+	return static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#endif
+}
+
+bool MappedFile::open(const std::string& filename, AccessMode accessMode)
+{
+	this->close();
+
+	_accessMode = accessMode;
+	_filename = filename;
+
+	std::error_code errorCode;
+	_size = std::filesystem::file_size(filename, errorCode);
+	if (errorCode || !_size) return false;
+
+#ifdef _WIN32
+	_fileHandle = CreateFileA(
+		filename.c_str(), accessMode == READ_WRITE ? GENERIC_READ | GENERIC_WRITE : GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+		FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (_fileHandle == INVALID_HANDLE_VALUE) return false;
+#else
+	_fileDescriptor = ::open(filename.c_str(), accessMode == READ_WRITE ? O_RDWR : O_RDONLY);
+	if (_fileDescriptor < 0) return false;
+#endif
+
+	return this->map();
+}
+
+void MappedFile::prefetch(size_t offset, size_t size) const
+{
+	char* begin;
+	size_t length;
+	if (!this->getPageRange(offset, size, begin, length)) return;
+
+#ifdef _WIN32
+	WIN32_MEMORY_RANGE_ENTRY range;
+	range.VirtualAddress = begin;
+	range.NumberOfBytes = length;
+
+	PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+#else
+	madvise(begin, length, MADV_WILLNEED);
+#endif
+}
+
+/// [Protected methods]
+
+bool MappedFile::getPageRange(size_t offset, size_t size, char*& begin, size_t& length) const
+{
+	if (!_data || offset >= _size) return false;
+
+	const size_t pageSize = MappedFile::getPageSize();
+	const size_t pageOffset = offset - offset % pageSize;
+	const size_t end = std::min(offset + size, _size);
+
+	begin = static_cast<char*>(_data) + pageOffset;
+	length = end - pageOffset;
+
+	return length > 0;
+}
+
+bool MappedFile::map()
+{
+	if (!_size)
+	{
+		this->close();
+		return false;
+	}
+
+#ifdef _WIN32
+	const bool write = _accessMode == READ_WRITE;
+	_mappingHandle = CreateFileMappingA(
+		_fileHandle, nullptr, write ? PAGE_READWRITE : PAGE_READONLY, static_cast<DWORD>(uint64_t(_size) >> 32), static_cast<DWORD>(uint64_t(_size) & 0xFFFFFFFF), nullptr);
+	if (_mappingHandle) _data = MapViewOfFile(_mappingHandle, write ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, _size);
+#else
+	void* data = mmap(nullptr, _size, _accessMode == READ_WRITE ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, _fileDescriptor, 0);
+	if (data != MAP_FAILED) _data = data;
+#endif
+
+	if (!_data)
+	{
+		this->close();
+		return false;
+	}
+
+	return true;
+}
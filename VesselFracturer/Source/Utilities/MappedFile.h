@@ -0,0 +1,113 @@
+#pragma once
+
+/**
+*	@file MappedFile.h
+*	@authors Alfonso Lpez Ruiz (alr00048@red.ujaen.es)
+*	@date 19/10/2026
+*/
+
+/**
+*	@brief File mapped into the address space of the process, so that data larger than the available RAM can be paged in and out by the OS.
+*/
+class MappedFile
+{
+public:
+	enum AccessMode { READ_ONLY, READ_WRITE };
+
+protected:
+	AccessMode		_accessMode;						//!< Access allowed for the mapped view
+	void*			_data;								//!< Beginning of the mapped view
+	std::string		_filename;							//!< Path of the mapped file
+	size_t			_size;								//!< Size of the mapped view in bytes
+
+#ifdef _WIN32
+	void*			_fileHandle;						//!< Windows file handle
+	void*			_mappingHandle;						//!< Windows file mapping handle
+#else
+	int				_fileDescriptor;					//!< POSIX file descriptor
+#endif
+
+protected:
+	/**
+	*	@brief Rounds the range [offset, offset + size) to whole pages, clamped to the mapped view.
+	*/
+	bool getPageRange(size_t offset, size_t size, char*& begin, size_t& length) const;
+
+	/**
+	*	@brief Maps the already opened file into memory.
+	*/
+	bool map();
+
+public:
+	/**
+	*	@brief Constructor.
+	*/
+	MappedFile();
+
+	/**
+	*	@brief Invalid copy constructor.
+	*/
+	MappedFile(const MappedFile& mappedFile) = delete;
+
+	/**
+	*	@brief Destructor. Unmaps the file and closes it.
+	*/
+	virtual ~MappedFile();
+
+	/**
+	*	@brief Unmaps the file and closes it.
+	*/
+	void close();
+
+	/**
+	*	@brief Creates (or truncates) a file with the given size and maps it for reading and writing.
+	*	@param temporary The file is removed once it is closed.
+	*/
+	bool create(const std::string& filename, size_t size, bool temporary = false);
+
+	/**
+	*	@return Beginning of the mapped view.
+	*/
+	void* data() const { return _data; }
+
+	/**
+	*	@brief Hints the OS that the pages of the given byte range are no longer needed. Modified pages are written back to the file before being dropped.
+	*/
+	void evict(size_t offset, size_t size);
+
+	/**
+	*	@brief Writes modified pages of the given byte range back to the file.
+	*/
+	void flush(size_t offset, size_t size);
+
+	/**
+	*	@return Path of the mapped file.
+	*/
+	std::string getFilename() const { return _filename; }
+
+	/**
+	*	@return Size of a memory page in bytes.
+	*/
+	static size_t getPageSize();
+
+	/**
+	*	@return True if a file is currently mapped.
+	*/
+	bool isOpen() const { return _data != nullptr; }
+
+	/**
+	*	@brief Maps an already existing file as a whole.
+	*/
+	bool open(const std::string& filename, AccessMode accessMode = READ_ONLY);
+
+	/**
+	*	@brief Hints the OS that the pages of the given byte range are about to be accessed, so that they can be read ahead.
+	*/
+	void prefetch(size_t offset, size_t size) const;
+
+	/**
+	*	@return Size of the mapped view in bytes.
+	*/
+	size_t size() const { return _size; }
+};
+
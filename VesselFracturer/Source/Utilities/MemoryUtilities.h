@@ -0,0 +1,53 @@
+#pragma once
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <unistd.h>
+#endif
+
+/**
+*	@file MemoryUtilities.h
+*	@authors Alfonso Lpez Ruiz (alr00048@red.ujaen.es)
+*	@date 19/10/2026
+*/
+
+/**
+*	@brief Utilities which help us to monitor the memory usage of the process.
+*/
+namespace MemoryUtilities
+{
+	//!< Units we can use to return the measured memory
+	enum MemoryUnit : size_t
+	{
+		GIGABYTES = 1 << 30, MEGABYTES = 1 << 20, KILOBYTES = 1 << 10, BYTES = 1
+	};
+
+	/**
+	*	@return Resident set size (working set in Windows) of the current process. By default the memory unit is megabytes.
+	*/
+	size_t getResidentSetSize(const MemoryUnit memoryUnit = MemoryUtilities::MEGABYTES);
+}
+
+inline size_t MemoryUtilities::getResidentSetSize(const MemoryUnit memoryUnit)
+{
+	size_t residentSetSize = 0;
+
+#ifdef _WIN32
+	PROCESS_MEMORY_COUNTERS memoryCounters;
+	if (GetProcessMemoryInfo(GetCurrentProcess(), &memoryCounters, sizeof(memoryCounters)))
+		residentSetSize = memoryCounters.WorkingSetSize;
+#else
+	size_t totalPages = 0, residentPages = 0;
+	std::ifstream statm("/proc/self/statm");
+
+	if (statm >> totalPages >> residentPages)
+		residentSetSize = residentPages * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#endif
+
+	return residentSetSize / memoryUnit;
+}
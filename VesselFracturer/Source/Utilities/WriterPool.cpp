@@ -0,0 +1,156 @@
+#include "stdafx.h"
+#include "WriterPool.h"
+
+// [Static attributes]
+
+const size_t WriterPool::MAX_QUEUED_BYTES = size_t(1) << 29;
+const unsigned WriterPool::MAX_QUEUED_JOBS = 64;
+const unsigned WriterPool::NUM_WORKERS = 4;
+
+// [Protected methods]
+
+WriterPool::WriterPool() :
+	_activeJobs(0), _bytesWritten(0), _failedJobs(0), _maxQueueDepth(0), _queuedBytes(0), _shutdown(false)
+{
+	for (unsigned workerIdx = 0; workerIdx < NUM_WORKERS; ++workerIdx)
+		_workers.push_back(std::thread(&WriterPool::work, this));
+}
+
+void WriterPool::run(QueuedJob& queuedJob)
+{
+	bool success = false;
+
+	try
+	{
+		success = queuedJob._job();
+	}
+	catch (const std::exception& exception)
+	{
+		std::cerr << "WriterPool: " << exception.what() << std::endl;
+	}
+
+	if (success)
+		_bytesWritten += queuedJob._size;
+	else
+		++_failedJobs;
+}
+
+void WriterPool::work()
+{
+	while (true)
+	{
+		QueuedJob queuedJob;
+
+		{
+			std::unique_lock<std::mutex> lock(_mutex);
+			_jobQueued.wait(lock, [this] { return _shutdown || !_jobs.empty(); });
+
+			if (_jobs.empty()) return;
+
+			queuedJob = std::move(_jobs.front());
+			_jobs.pop_front();
+			_queuedBytes -= queuedJob._size;
+			++_activeJobs;
+		}
+
+		_jobTaken.notify_all();
+		this->run(queuedJob);
+
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			--_activeJobs;
+		}
+
+		_jobFinished.notify_all();
+	}
+}
+
+// [Public methods]
+
+WriterPool::~WriterPool()
+{
+	this->shutdown();
+}
+
+void WriterPool::flush()
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	_jobFinished.wait(lock, [this] { return _jobs.empty() && _activeJobs == 0; });
+}
+
+size_t WriterPool::getMaxQueueDepth()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _maxQueueDepth;
+}
+
+size_t WriterPool::getQueueDepth()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _jobs.size();
+}
+
+void WriterPool::resetStatistics()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	_bytesWritten = 0;
+	_failedJobs = 0;
+	_maxQueueDepth = _jobs.size();
+}
+
+void WriterPool::shutdown()
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		if (_shutdown) return;
+
+		_shutdown = true;
+	}
+
+	_jobQueued.notify_all();
+
+	for (std::thread& worker : _workers)
+		worker.join();
+
+	_workers.clear();
+}
+
+void WriterPool::submit(Job job, size_t size)
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+
+	if (_shutdown)
+	{
+		lock.unlock();
+
+		QueuedJob queuedJob{ std::move(job), size };
+		this->run(queuedJob);
+		return;
+	}
+
+	_jobTaken.wait(lock, [this, size] { return _jobs.empty() || (_jobs.size() < MAX_QUEUED_JOBS && _queuedBytes + size <= MAX_QUEUED_BYTES); });
+
+	_jobs.push_back(QueuedJob{ std::move(job), size });
+	_queuedBytes += size;
+	_maxQueueDepth = std::max(_maxQueueDepth, _jobs.size());
+
+	lock.unlock();
+	_jobQueued.notify_one();
+}
+
+void WriterPool::write(const std::string& filename, std::vector<char>&& data)
+{
+	const size_t size = data.size();
+	std::shared_ptr<std::vector<char>> buffer = std::make_shared<std::vector<char>>(std::move(data));
+
+	this->submit([filename, buffer]()
+		{
+			std::ofstream stream(filename, std::ios::out | std::ios::binary | std::ios::trunc);
+			if (!stream.is_open()) return false;
+
+			stream.write(buffer->data(), buffer->size());
+			stream.close();
+
+			return !stream.fail();
+		}, size);
+}
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+
+#include "Utilities/Singleton.h"
+
+/**
+*	@file WriterPool.h
+*	@authors Alfonso Lpez Ruiz (alr00048@red.ujaen.es)
+*	@date 19/10/2026
+*/
+
+/**
+*	@brief Fixed set of I/O threads which consume write jobs from a bounded queue. Producers block while the queue is full, so 
+*	the disk is kept busy without accumulating an unbounded amount of pending data in memory. Pending jobs are completed on flush 
+*	and before the pool is destroyed.
+*/
+class WriterPool : public Singleton<WriterPool>
+{
+	friend class Singleton<WriterPool>;
+
+public:
+	typedef std::function<bool()> Job;							//!< Writes something and returns whether it succeeded
+
+protected:
+	static const size_t		MAX_QUEUED_BYTES;					//!< Maximum number of bytes announced by queued jobs
+	static const unsigned	MAX_QUEUED_JOBS;					//!< Maximum number of queued jobs
+	static const unsigned	NUM_WORKERS;						//!< Number of I/O threads
+
+protected:
+	struct QueuedJob
+	{
+		Job					_job;								//!< Task to be executed
+		size_t				_size;								//!< Number of bytes written by the task
+	};
+
+protected:
+	unsigned						_activeJobs;				//!< Number of jobs being executed by the workers
+	std::atomic<uint64_t>			_bytesWritten;				//!< Number of bytes written by successful jobs
+	std::atomic<unsigned>			_failedJobs;				//!< Number of jobs which did not succeed
+	std::condition_variable			_jobFinished;				//!< Signaled when a worker completes a job
+	std::deque<QueuedJob>			_jobs;						//!< Pending jobs
+	std::condition_variable			_jobQueued;					//!< Signaled when a job is queued or the pool is shut down
+	std::condition_variable			_jobTaken;					//!< Signaled when a queue slot is released
+	size_t							_maxQueueDepth;				//!< Peak number of queued jobs
+	std::mutex						_mutex;						//!< Guards the queue and the counters not declared as atomic
+	size_t							_queuedBytes;				//!< Number of bytes announced by queued jobs
+	bool							_shutdown;					//!< No more jobs are accepted by the workers
+	std::vector<std::thread>		_workers;					//!< I/O threads
+
+protected:
+	/**
+	*	@brief Constructor. Launches the workers.
+	*/
+	WriterPool();
+
+	/**
+	*	@brief Executes a job and updates the counters.
+	*/
+	void run(QueuedJob& queuedJob);
+
+	/**
+	*	@brief Loop of every worker, which ends once the pool is shut down and the queue is empty.
+	*/
+	void work();
+
+public:
+	/**
+	*	@brief Destructor. Completes the pending jobs.
+	*/
+	virtual ~WriterPool();
+
+	/**
+	*	@brief Blocks until every queued job has been completed.
+	*/
+	void flush();
+
+	/**
+	*	@return Number of bytes written by successful jobs.
+	*/
+	uint64_t getBytesWritten() const { return _bytesWritten; }
+
+	/**
+	*	@return Peak number of queued jobs.
+	*/
+	size_t getMaxQueueDepth();
+
+	/**
+	*	@return Number of jobs which did not succeed.
+	*/
+	unsigned getNumFailedJobs() const { return _failedJobs; }
+
+	/**
+	*	@return Number of jobs waiting for a worker.
+	*/
+	size_t getQueueDepth();
+
+	/**
+	*	@brief Restarts the counters of written bytes, failed jobs and peak queue depth, e.g. to report them per batch of files.
+	*/
+	void resetStatistics();
+
+	/**
+	*	@brief Completes the pending jobs and stops the workers. Jobs submitted afterwards are executed by the calling thread.
+	*/
+	void shutdown();
+
+	/**
+	*	@brief Queues a job, blocking while the queue is full. An empty queue always accepts a job, regardless of its size.
+	*	@param size Number of bytes written by the job, used for backpressure and counting.
+	*/
+	void submit(Job job, size_t size = 0);
+
+	/**
+	*	@brief Queues the writing of a binary file whose content is already in memory.
+	*/
+	void write(const std::string& filename, std::vector<char>&& data);
+};
+
@@ -0,0 +1,406 @@
+#include "stdafx.h"
+#include "ZipArchive.h"
+
+#include <ctime>
+
+#include "Utilities/WriterPool.h"
+
+// [Static attributes]
+
+const unsigned ZipArchive::HASH_SIZE = 1 << 15;
+const unsigned ZipArchive::MAX_CHAIN_LENGTH = 32;
+const unsigned ZipArchive::MAX_MATCH = 258;
+const unsigned ZipArchive::MIN_MATCH = 3;
+const unsigned ZipArchive::WINDOW_SIZE = 1 << 15;
+
+// [Public methods]
+
+ZipArchive::ZipArchive() :
+	_dosDate(0), _dosTime(0), _failed(false), _method(DEFLATE), _offset(0), _pendingEntries(0)
+{
+}
+
+ZipArchive::~ZipArchive()
+{
+	if (_stream.is_open())
+		this->close();
+}
+
+bool ZipArchive::add(const std::string& name, std::vector<char>&& data)
+{
+	if (!_stream.is_open() || data.size() >= std::numeric_limits<uint32_t>::max() || name.size() > std::numeric_limits<uint16_t>::max()) return false;
+
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		++_pendingEntries;
+	}
+
+	const size_t size = data.size();
+	std::shared_ptr<std::vector<char>> buffer = std::make_shared<std::vector<char>>(std::move(data));
+
+	auto job = [this, name, buffer]()
+		{
+			Entry entry;
+			entry._name = name;
+			entry._size = static_cast<uint32_t>(buffer->size());
+			entry._crc = getCRC32(*buffer);
+
+			// Data which does not shrink is stored as it is
+			std::vector<char> compressed;
+			if (_method == DEFLATE) deflate(*buffer, compressed);
+
+			const bool deflated = _method == DEFLATE && compressed.size() < buffer->size();
+			entry._method = deflated ? DEFLATE : STORE;
+			entry._compressedSize = static_cast<uint32_t>(deflated ? compressed.size() : buffer->size());
+
+			return this->append(entry, deflated ? compressed : *buffer);
+		};
+
+	// The entry must leave the pending ones on every path (even if compression throws), otherwise close() waits forever
+	try
+	{
+		WriterPool::getInstance()->submit([this, job]()
+			{
+				bool success = false;
+
+				try
+				{
+					success = job();
+				}
+				catch (...)
+				{
+					this->finishEntry(false);
+					throw;
+				}
+
+				this->finishEntry(success);
+
+				return success;
+			}, size);
+	}
+	catch (...)
+	{
+		this->finishEntry(false);
+		return false;
+	}
+
+	return true;
+}
+
+bool ZipArchive::close()
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	_entryWritten.wait(lock, [this] { return _pendingEntries == 0; });
+
+	if (!_stream.is_open()) return false;
+
+	std::vector<char> directory;
+	auto push = [&directory](auto value) {
+		const char* bytes = reinterpret_cast<const char*>(&value);
+		directory.insert(directory.end(), bytes, bytes + sizeof(value));
+	};
+
+	// Central directory, with the offset moved to a ZIP64 extra field when it does not fit
+	const uint64_t directoryOffset = _offset;
+	for (const Entry& entry : _entries)
+	{
+		const bool offset64 = entry._offset >= std::numeric_limits<uint32_t>::max();
+
+		push(uint32_t(0x02014b50));
+		push(uint16_t(offset64 ? 45 : 20));
+		push(uint16_t(offset64 ? 45 : 20));
+		push(uint16_t(0x0800));
+		push(entry._method);
+		push(_dosTime);
+		push(_dosDate);
+		push(entry._crc);
+		push(entry._compressedSize);
+		push(entry._size);
+		push(uint16_t(entry._name.size()));
+		push(uint16_t(offset64 ? 12 : 0));
+		push(uint16_t(0));
+		push(uint16_t(0));
+		push(uint16_t(0));
+		push(uint32_t(0));
+		push(uint32_t(offset64 ? std::numeric_limits<uint32_t>::max() : entry._offset));
+		directory.insert(directory.end(), entry._name.begin(), entry._name.end());
+
+		if (offset64)
+		{
+			push(uint16_t(0x0001));
+			push(uint16_t(8));
+			push(entry._offset);
+		}
+	}
+
+	const uint64_t directorySize = directory.size();
+	const bool zip64 = _entries.size() >= std::numeric_limits<uint16_t>::max() || directoryOffset >= std::numeric_limits<uint32_t>::max() || directorySize >= std::numeric_limits<uint32_t>::max();
+
+	if (zip64)
+	{
+		const uint64_t recordOffset = directoryOffset + directorySize;
+
+		push(uint32_t(0x06064b50));
+		push(uint64_t(44));
+		push(uint16_t(45));
+		push(uint16_t(45));
+		push(uint32_t(0));
+		push(uint32_t(0));
+		push(uint64_t(_entries.size()));
+		push(uint64_t(_entries.size()));
+		push(directorySize);
+		push(directoryOffset);
+
+		push(uint32_t(0x07064b50));
+		push(uint32_t(0));
+		push(recordOffset);
+		push(uint32_t(1));
+	}
+
+	push(uint32_t(0x06054b50));
+	push(uint16_t(0));
+	push(uint16_t(0));
+	push(uint16_t(zip64 ? std::numeric_limits<uint16_t>::max() : _entries.size()));
+	push(uint16_t(zip64 ? std::numeric_limits<uint16_t>::max() : _entries.size()));
+	push(uint32_t(zip64 ? std::numeric_limits<uint32_t>::max() : directorySize));
+	push(uint32_t(zip64 ? std::numeric_limits<uint32_t>::max() : directoryOffset));
+	push(uint16_t(0));
+
+	_stream.write(directory.data(), directory.size());
+	_stream.close();
+	_entries.clear();
+
+	return !_failed && !_stream.fail();
+}
+
+bool ZipArchive::open(const std::string& filename, Method method)
+{
+	if (_stream.is_open())
+		this->close();
+
+	_stream.open(filename, std::ios::out | std::ios::binary | std::ios::trunc);
+	if (!_stream.is_open()) return false;
+
+	_entries.clear();
+	_failed = false;
+	_filename = filename;
+	_method = method;
+	_offset = 0;
+
+	// Every entry is dated when the archive is created
+	const std::time_t now = std::time(nullptr);
+	const std::tm* localTime = std::localtime(&now);
+	_dosTime = static_cast<uint16_t>(localTime->tm_hour << 11 | localTime->tm_min << 5 | localTime->tm_sec / 2);
+	_dosDate = static_cast<uint16_t>(std::max(localTime->tm_year - 80, 0) << 9 | (localTime->tm_mon + 1) << 5 | localTime->tm_mday);
+
+	return true;
+}
+
+// [Protected methods]
+
+bool ZipArchive::append(Entry& entry, const std::vector<char>& data)
+{
+	std::vector<char> header;
+	auto push = [&header](auto value) {
+		const char* bytes = reinterpret_cast<const char*>(&value);
+		header.insert(header.end(), bytes, bytes + sizeof(value));
+	};
+
+	// Sizes are known beforehand, so the local header is complete and no data descriptor is needed
+	push(uint32_t(0x04034b50));
+	push(uint16_t(20));
+	push(uint16_t(0x0800));
+	push(entry._method);
+	push(_dosTime);
+	push(_dosDate);
+	push(entry._crc);
+	push(entry._compressedSize);
+	push(entry._size);
+	push(uint16_t(entry._name.size()));
+	push(uint16_t(0));
+	header.insert(header.end(), entry._name.begin(), entry._name.end());
+
+	bool success;
+
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+
+		entry._offset = _offset;
+		_stream.write(header.data(), header.size());
+		_stream.write(data.data(), data.size());
+		_offset += header.size() + data.size();
+
+		success = !_stream.fail();
+		if (success)
+			_entries.push_back(entry);
+	}
+
+	return success;
+}
+
+void ZipArchive::deflate(const std::vector<char>& data, std::vector<char>& compressed)
+{
+	static const uint16_t lengthBase[] = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+	static const uint8_t lengthExtra[] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+	static const uint16_t distanceBase[] = { 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+	static const uint8_t distanceExtra[] = { 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+
+	compressed.clear();
+	compressed.reserve(data.size() / 2 + 64);
+
+	// Bits are packed from the least significant one, whereas Huffman codes are sent from their most significant bit
+	uint64_t bitBuffer = 0;
+	unsigned numBits = 0;
+
+	auto writeBits = [&](uint32_t value, unsigned length) {
+		bitBuffer |= uint64_t(value) << numBits;
+		numBits += length;
+
+		while (numBits >= 8)
+		{
+			compressed.push_back(static_cast<char>(bitBuffer & 0xFF));
+			bitBuffer >>= 8;
+			numBits -= 8;
+		}
+	};
+
+	// Fixed codes of literals and lengths, already reversed
+	struct Code { uint16_t _bits, _length; };
+	static const std::vector<Code> symbolCodes = [] {
+		std::vector<Code> codes(288);
+		for (unsigned symbol = 0; symbol < 288; ++symbol)
+		{
+			uint16_t code, length;
+			if (symbol < 144) { code = 0x30 + symbol; length = 8; }
+			else if (symbol < 256) { code = 0x190 + symbol - 144; length = 9; }
+			else if (symbol < 280) { code = symbol - 256; length = 7; }
+			else { code = 0xC0 + symbol - 280; length = 8; }
+
+			codes[symbol] = Code{ 0, length };
+			for (unsigned bit = 0; bit < length; ++bit)
+				codes[symbol]._bits |= ((code >> bit) & 1) << (length - 1 - bit);
+		}
+
+		return codes;
+	}();
+
+	auto writeSymbol = [&](unsigned symbol) {
+		writeBits(symbolCodes[symbol]._bits, symbolCodes[symbol]._length);
+	};
+
+	auto writeDistanceCode = [&](unsigned code) {
+		uint32_t reversed = 0;
+		for (unsigned bit = 0; bit < 5; ++bit)
+			reversed |= ((code >> bit) & 1) << (4 - bit);
+
+		writeBits(reversed, 5);
+	};
+
+	// Single final block with fixed codes
+	writeBits(1, 1);
+	writeBits(1, 2);
+
+	const uint8_t* bytes = reinterpret_cast<const uint8_t*>(data.data());
+	const size_t size = data.size();
+	std::vector<int64_t> head(HASH_SIZE, -1), previous(WINDOW_SIZE, -1);
+
+	auto getHash = [&](size_t position) {
+		return ((uint32_t(bytes[position]) << 16 | uint32_t(bytes[position + 1]) << 8 | bytes[position + 2]) * 2654435761u) >> (32 - 15);
+	};
+
+	auto insert = [&](size_t position) {
+		if (position + MIN_MATCH > size) return;
+
+		const uint32_t hash = getHash(position);
+		previous[position & (WINDOW_SIZE - 1)] = head[hash];
+		head[hash] = static_cast<int64_t>(position);
+	};
+
+	size_t position = 0;
+	while (position < size)
+	{
+		unsigned bestLength = 0;
+		size_t bestDistance = 0;
+
+		if (position + MIN_MATCH <= size)
+		{
+			const size_t maxLength = std::min<size_t>(MAX_MATCH, size - position);
+			int64_t candidate = head[getHash(position)];
+
+			for (unsigned chain = 0; chain < MAX_CHAIN_LENGTH && candidate >= 0 && position - candidate <= WINDOW_SIZE; ++chain)
+			{
+				unsigned length = 0;
+				while (length < maxLength && bytes[candidate + length] == bytes[position + length]) ++length;
+
+				if (length > bestLength)
+				{
+					bestLength = length;
+					bestDistance = position - candidate;
+					if (length == maxLength) break;
+				}
+
+				candidate = previous[candidate & (WINDOW_SIZE - 1)];
+			}
+		}
+
+		if (bestLength >= MIN_MATCH)
+		{
+			const unsigned lengthCode = static_cast<unsigned>(std::upper_bound(lengthBase, lengthBase + 29, bestLength) - lengthBase) - 1;
+			writeSymbol(257 + lengthCode);
+			writeBits(bestLength - lengthBase[lengthCode], lengthExtra[lengthCode]);
+
+			const unsigned distanceCode = static_cast<unsigned>(std::upper_bound(distanceBase, distanceBase + 30, bestDistance) - distanceBase) - 1;
+			writeDistanceCode(distanceCode);
+			writeBits(static_cast<uint32_t>(bestDistance - distanceBase[distanceCode]), distanceExtra[distanceCode]);
+
+			for (unsigned offset = 0; offset < bestLength; ++offset)
+				insert(position + offset);
+
+			position += bestLength;
+		}
+		else
+		{
+			writeSymbol(bytes[position]);
+			insert(position);
+			++position;
+		}
+	}
+
+	writeSymbol(256);
+	if (numBits > 0) writeBits(0, 8 - numBits);
+}
+
+void ZipArchive::finishEntry(bool success)
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+
+		_failed |= !success;
+		--_pendingEntries;
+	}
+
+	_entryWritten.notify_all();
+}
+
+uint32_t ZipArchive::getCRC32(const std::vector<char>& data)
+{
+	static const std::vector<uint32_t> table = [] {
+		std::vector<uint32_t> table(256);
+		for (uint32_t byte = 0; byte < 256; ++byte)
+		{
+			uint32_t crc = byte;
+			for (int bit = 0; bit < 8; ++bit)
+				crc = crc & 1 ? 0xEDB88320u ^ (crc >> 1) : crc >> 1;
+
+			table[byte] = crc;
+		}
+
+		return table;
+	}();
+
+	uint32_t crc = 0xFFFFFFFFu;
+	for (char byte : data)
+		crc = table[(crc ^ static_cast<uint8_t>(byte)) & 0xFF] ^ (crc >> 8);
+
+	return crc ^ 0xFFFFFFFFu;
+}
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <condition_variable>
+#include <mutex>
+
+/**
+*	@file ZipArchive.h
+*	@authors Alfonso Lpez Ruiz (alr00048@red.ujaen.es)
+*	@date 19/10/2026
+*/
+
+/**
+*	@brief ZIP archive written as entries are produced. Every entry is compressed (deflate with fixed Huffman codes, or stored if that 
+*	does not pay off) by the writer pool and appended to the archive as soon as it is ready, hence files are never written nor read 
+*	back separately. The central directory is written on close, with ZIP64 records if the archive exceeds the classic limits.
+*/
+class ZipArchive
+{
+public:
+	enum Method { STORE = 0, DEFLATE = 8 };
+
+protected:
+	static const unsigned		HASH_SIZE;						//!< Number of heads of the match chains
+	static const unsigned		MAX_CHAIN_LENGTH;				//!< Maximum number of candidates tested for every match
+	static const unsigned		MAX_MATCH;						//!< Maximum length of a match
+	static const unsigned		MIN_MATCH;						//!< Minimum length of a match
+	static const unsigned		WINDOW_SIZE;					//!< Maximum distance of a match
+
+protected:
+	struct Entry
+	{
+		uint32_t		_compressedSize;						//!< Size of the stored data
+		uint32_t		_crc;									//!< CRC-32 of the original data
+		uint16_t		_method;								//!< Compression method
+		std::string		_name;									//!< Path of the file within the archive
+		uint64_t		_offset;								//!< Position of the local header in the archive
+		uint32_t		_size;									//!< Size of the original data
+	};
+
+protected:
+	uint16_t					_dosDate, _dosTime;				//!< Modification date and time of every entry
+	std::vector<Entry>			_entries;						//!< Entries already written
+	bool						_failed;						//!< Any entry could not be written
+	std::string					_filename;						//!< Path of the archive
+	Method						_method;						//!< Preferred compression method
+	std::mutex					_mutex;							//!< Guards the file and the entries
+	uint64_t					_offset;						//!< Current size of the archive
+	unsigned					_pendingEntries;				//!< Entries queued but not written yet
+	std::condition_variable		_entryWritten;					//!< Signaled when a pending entry is written
+	std::ofstream				_stream;						//!< Output file
+
+protected:
+	/**
+	*	@brief Appends an already compressed entry to the archive. Executed by the writer pool.
+	*/
+	bool append(Entry& entry, const std::vector<char>& data);
+
+	/**
+	*	@brief Removes a queued entry from the pending ones, whether it was written or not, and wakes up close().
+	*/
+	void finishEntry(bool success);
+
+	/**
+	*	@brief Compresses the data as a single deflate block with fixed Huffman codes.
+	*/
+	static void deflate(const std::vector<char>& data, std::vector<char>& compressed);
+
+	/**
+	*	@return CRC-32 of the data.
+	*/
+	static uint32_t getCRC32(const std::vector<char>& data);
+
+public:
+	/**
+	*	@brief Constructor.
+	*/
+	ZipArchive();
+
+	/**
+	*	@brief Invalid copy constructor.
+	*/
+	ZipArchive(const ZipArchive& archive) = delete;
+
+	/**
+	*	@brief Destructor. Closes the archive if it is open.
+	*/
+	virtual ~ZipArchive();
+
+	/**
+	*	@brief Queues a new entry, which is compressed and written by the writer pool.
+	*	@param name Path of the file within the archive.
+	*	@return False if the archive is not open or the entry is too large.
+	*/
+	bool add(const std::string& name, std::vector<char>&& data);
+
+	/**
+	*	@brief Waits for the pending entries, writes the central directory and closes the file.
+	*	@return False if any entry or the directory could not be written.
+	*/
+	bool close();
+
+	/**
+	*	@return Path of the archive.
+	*/
+	std::string getFilename() const { return _filename; }
+
+	/**
+	*	@brief Checks whether entries can be added.
+	*/
+	bool isOpen() const { return _stream.is_open(); }
+
+	/**
+	*	@brief Creates (or truncates) an archive.
+	*/
+	bool open(const std::string& filename, Method method = DEFLATE);
+};
+